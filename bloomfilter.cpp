@@ -0,0 +1,64 @@
+/**
+ * \file bloomfilter.cpp
+ *
+ * \brief Implementation of BloomFilter.
+ */
+
+#include "bloomfilter.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+/// Odd multipliers that pick an independent bit for each word of a block.
+constexpr uint32_t SALTS[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                               0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                               0x9efc4947U, 0x5c6bfb31U};
+
+}  // namespace
+
+BloomFilter::BloomFilter(size_t expectedKeys, size_t bitsPerKey)
+    : blocks_(std::max<size_t>(1, (expectedKeys * bitsPerKey + 255) / 256),
+              Block{}) {
+    // Nothing else to do.
+}
+
+BloomFilter::Block BloomFilter::maskFor(uint32_t hash) {
+    Block mask;
+    for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+        mask.words[i] = uint32_t(1) << ((hash * SALTS[i]) >> 27);
+    }
+    return mask;
+}
+
+size_t BloomFilter::blockIndex(uint64_t hash) const {
+    // Scale the high half of the hash onto the blocks; the low half picks
+    // the bits.
+    return (uint64_t(uint32_t(hash >> 32)) * blocks_.size()) >> 32;
+}
+
+void BloomFilter::insert(const std::string& word) {
+    uint64_t hash = std::hash<std::string>{}(word);
+    Block& block = blocks_[blockIndex(hash)];
+    Block mask = maskFor(uint32_t(hash));
+    for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+        block.words[i] |= mask.words[i];
+    }
+}
+
+bool BloomFilter::mayContain(const std::string& word) const {
+    uint64_t hash = std::hash<std::string>{}(word);
+    const Block& block = blocks_[blockIndex(hash)];
+    Block mask = maskFor(uint32_t(hash));
+    // Check every word without branching, so the loop can vectorize.
+    uint32_t missing = 0;
+    for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+        missing |= mask.words[i] & ~block.words[i];
+    }
+    return missing == 0;
+}
+
+size_t BloomFilter::bytesUsed() const {
+    return blocks_.size() * sizeof(Block);
+}
@@ -0,0 +1,77 @@
+/**
+ * \file bloomfilter.hpp
+ *
+ * \brief An approximate set of strings that can rule words out cheaply.
+ */
+
+#ifndef BLOOMFILTER_HPP_INCLUDED
+#define BLOOMFILTER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \class BloomFilter
+ * \brief A split-block Bloom filter over strings.
+ *
+ * \details
+ * The filter is an array of 256-bit blocks, each made of eight 32-bit
+ * words.  A string hashes to one block and sets one bit in each of its
+ * eight words, so checking a string touches a single 32-byte block (half a
+ * cache line).  mayContain() never says no to a string that was inserted,
+ * but may say yes to one that wasn't; with the default ten bits per
+ * expected key that happens about 1% of the time.
+ *
+ * Concurrent calls to mayContain() are fine; insert() needs the filter to
+ * itself.
+ */
+class BloomFilter {
+ public:
+    /**
+     * \brief Creates an empty filter.
+     * \param expectedKeys How many strings will be inserted.
+     * \param bitsPerKey   Filter bits to use per expected string.
+     */
+    explicit BloomFilter(size_t expectedKeys, size_t bitsPerKey = 10);
+
+    /**
+     * \brief Adds a string to the filter.
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Checks whether a string might have been inserted.
+     * \param word The string to look for.
+     * \returns False only if the word was definitely never inserted.
+     */
+    bool mayContain(const std::string& word) const;
+
+    /**
+     * \brief Size of the filter's bit array.
+     */
+    size_t bytesUsed() const;
+
+ private:
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+
+    struct Block {
+        uint32_t words[WORDS_PER_BLOCK];
+    };
+
+    /**
+     * \brief The bit each word of a block would have set for a hash.
+     */
+    static Block maskFor(uint32_t hash);
+
+    /**
+     * \brief Index of the block a hash selects.
+     */
+    size_t blockIndex(uint64_t hash) const;
+
+    std::vector<Block> blocks_;
+};
+
+#endif  // BLOOMFILTER_HPP_INCLUDED
@@ -0,0 +1,249 @@
+/**
+ * \file btreestringset-private.hpp
+ *
+ * \brief Implementation of BTreeStringSet.
+ */
+
+#include <algorithm>
+
+// ---------------------------------------------------------------------
+// ConstIterator
+// ---------------------------------------------------------------------
+
+template <size_t FANOUT>
+BTreeStringSet<FANOUT>::ConstIterator::ConstIterator(const Node* leaf,
+                                                     size_t index)
+    : leaf_{leaf}, index_{index} {
+    // Nothing else to do.
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator::reference
+BTreeStringSet<FANOUT>::ConstIterator::operator*() const {
+    return leaf_->keys[index_];
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator::pointer
+BTreeStringSet<FANOUT>::ConstIterator::operator->() const {
+    return &leaf_->keys[index_];
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator&
+BTreeStringSet<FANOUT>::ConstIterator::operator++() {
+    ++index_;
+    if (index_ == leaf_->numKeys) {
+        leaf_ = leaf_->next;
+        index_ = 0;
+    }
+    return *this;
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator
+BTreeStringSet<FANOUT>::ConstIterator::operator++(int) {
+    ConstIterator old = *this;
+    ++*this;
+    return old;
+}
+
+template <size_t FANOUT>
+bool BTreeStringSet<FANOUT>::ConstIterator::operator==(
+    const ConstIterator& other) const {
+    return leaf_ == other.leaf_ && index_ == other.index_;
+}
+
+template <size_t FANOUT>
+bool BTreeStringSet<FANOUT>::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+    return !(*this == other);
+}
+
+// ---------------------------------------------------------------------
+// BTreeStringSet
+// ---------------------------------------------------------------------
+
+template <size_t FANOUT>
+BTreeStringSet<FANOUT>::Node::Node(bool isLeaf) : leaf{isLeaf} {
+    // Nothing else to do.
+}
+
+template <size_t FANOUT>
+BTreeStringSet<FANOUT>::BTreeStringSet(bool useArena)
+    : useArena_{useArena}, root_{newNode(true)}, firstLeaf_{root_} {
+    // Nothing else to do.
+}
+
+template <size_t FANOUT>
+BTreeStringSet<FANOUT>::~BTreeStringSet() {
+    // Nodes in the arena go when it does.
+    if (!useArena_) {
+        destroy(root_);
+    }
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::Node* BTreeStringSet<FANOUT>::newNode(
+    bool isLeaf) {
+    return useArena_ ? arena_.make(isLeaf) : new Node(isLeaf);
+}
+
+template <size_t FANOUT>
+void BTreeStringSet<FANOUT>::destroy(Node* node) {
+    if (!node->leaf) {
+        for (size_t i = 0; i <= node->numKeys; ++i) {
+            destroy(node->children[i]);
+        }
+    }
+    delete node;
+}
+
+template <size_t FANOUT>
+size_t BTreeStringSet<FANOUT>::size() const {
+    return size_;
+}
+
+template <size_t FANOUT>
+size_t BTreeStringSet<FANOUT>::height() const {
+    return height_;
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator
+BTreeStringSet<FANOUT>::begin() const {
+    return size_ == 0 ? end() : ConstIterator(firstLeaf_, 0);
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::ConstIterator
+BTreeStringSet<FANOUT>::end() const {
+    return ConstIterator();
+}
+
+template <size_t FANOUT>
+size_t BTreeStringSet<FANOUT>::childIndex(const Node* node,
+                                          const std::string& word) {
+    // Keys equal to a separator live in the child to its right.
+    return std::upper_bound(node->keys, node->keys + node->numKeys, word)
+           - node->keys;
+}
+
+template <size_t FANOUT>
+bool BTreeStringSet<FANOUT>::exists(const std::string& word) const {
+    const Node* node = root_;
+    while (!node->leaf) {
+        node = node->children[childIndex(node, word)];
+    }
+    const std::string_view* last = node->keys + node->numKeys;
+    const std::string_view* found = std::lower_bound(node->keys, last, word);
+    return found != last && *found == word;
+}
+
+template <size_t FANOUT>
+void BTreeStringSet<FANOUT>::insert(const std::string& word) {
+    std::string_view separator;
+    bool added = false;
+    Node* sibling = insertHelper(root_, word, separator, added);
+    if (sibling != nullptr) {
+        // The root split, so the tree grows a level.
+        Node* newRoot = newNode(false);
+        newRoot->numKeys = 1;
+        newRoot->keys[0] = separator;
+        newRoot->children[0] = root_;
+        newRoot->children[1] = sibling;
+        root_ = newRoot;
+        ++height_;
+    }
+    if (added) {
+        ++size_;
+    }
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::Node* BTreeStringSet<FANOUT>::insertHelper(
+    Node* node, const std::string& word, std::string_view& separator,
+    bool& added) {
+    if (node->leaf) {
+        std::string_view* last = node->keys + node->numKeys;
+        std::string_view* pos = std::lower_bound(node->keys, last, word);
+        if (pos != last && *pos == word) {
+            return nullptr;
+        }
+        std::copy_backward(pos, last, last + 1);
+        *pos = chars_.add(word);
+        ++node->numKeys;
+        added = true;
+    } else {
+        size_t i = childIndex(node, word);
+        std::string_view childSeparator;
+        Node* sibling =
+            insertHelper(node->children[i], word, childSeparator, added);
+        if (sibling == nullptr) {
+            return nullptr;
+        }
+        // Make room for the new child just right of the one that split.
+        std::copy_backward(node->keys + i, node->keys + node->numKeys,
+                           node->keys + node->numKeys + 1);
+        std::copy_backward(node->children + i + 1,
+                           node->children + node->numKeys + 1,
+                           node->children + node->numKeys + 2);
+        node->keys[i] = childSeparator;
+        node->children[i + 1] = sibling;
+        ++node->numKeys;
+    }
+    return node->numKeys == FANOUT ? split(node, separator) : nullptr;
+}
+
+template <size_t FANOUT>
+typename BTreeStringSet<FANOUT>::Node* BTreeStringSet<FANOUT>::split(
+    Node* node, std::string_view& separator) {
+    Node* right = newNode(node->leaf);
+    size_t mid = FANOUT / 2;
+    if (node->leaf) {
+        // The right leaf keeps its first key; the parent gets a copy.
+        std::copy(node->keys + mid, node->keys + FANOUT, right->keys);
+        right->numKeys = FANOUT - mid;
+        separator = right->keys[0];
+        right->next = node->next;
+        node->next = right;
+    } else {
+        // The middle key moves up to the parent.
+        separator = node->keys[mid];
+        std::copy(node->keys + mid + 1, node->keys + FANOUT, right->keys);
+        std::copy(node->children + mid + 1, node->children + FANOUT + 1,
+                  right->children);
+        right->numKeys = FANOUT - mid - 1;
+    }
+    node->numKeys = mid;
+    return right;
+}
+
+template <size_t FANOUT>
+void BTreeStringSet<FANOUT>::countNodes(const Node* node, size_t& leaves,
+                                        size_t& interior) const {
+    if (node->leaf) {
+        ++leaves;
+        return;
+    }
+    ++interior;
+    for (size_t i = 0; i <= node->numKeys; ++i) {
+        countNodes(node->children[i], leaves, interior);
+    }
+}
+
+template <size_t FANOUT>
+void BTreeStringSet<FANOUT>::showStatistics(std::ostream& out) const {
+    size_t leaves = 0;
+    size_t interior = 0;
+    countNodes(root_, leaves, interior);
+    out << size_ << " keys in B+-tree of fanout " << FANOUT << ", height "
+        << height_ << ", " << leaves << " leaves, " << interior
+        << " interior nodes, " << (100.0 * size_ / (leaves * (FANOUT - 1)))
+        << "% leaf fill, " << chars_.bytesUsed() << " bytes of keys";
+    if (useArena_) {
+        out << ", nodes in " << arena_.slabs() << " slabs of "
+            << arena_.SLAB_OBJECTS;
+    }
+    out << "\n";
+}
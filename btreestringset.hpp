@@ -0,0 +1,196 @@
+/**
+ * \file btreestringset.hpp
+ *
+ * \brief A string set stored in a B+-tree.
+ */
+
+#ifndef BTREESTRINGSET_HPP_INCLUDED
+#define BTREESTRINGSET_HPP_INCLUDED
+
+#include "slabpool.hpp"
+#include "stringarena.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * \class BTreeStringSet
+ * \brief A set of strings in a B+-tree, with the same interface as
+ *        TreeStringSet.
+ *
+ * \tparam FANOUT  Maximum number of children of an interior node (and
+ *                 maximum number of keys in a leaf).
+ *
+ * \details
+ * Each node holds many keys, so a lookup touches only about
+ * log_FANOUT(n) nodes instead of log_2(n).  All keys live in the leaves,
+ * which are chained left to right for iteration; interior nodes hold
+ * copies of the first key of each child after the first.
+ *
+ * Each key's characters are stored once, in a StringArena the set owns,
+ * and nodes (leaves and interior nodes alike) hold string_views of them.
+ * A view is 16 bytes, so the default fanout keeps one node's key array at
+ * four 64-byte cache lines.  Smaller fanouts make shallower searches
+ * within a node but taller trees.
+ *
+ * Nodes normally come from new, one allocation each, and are freed by
+ * walking the tree.  Given useArena, the tree allocates them from a
+ * SlabPool instead, so nodes made one after another sit together, and,
+ * since a node has nothing to destroy, the whole tree is freed a slab at a
+ * time.
+ *
+ * exists() and iteration don't modify the tree, so several threads may do
+ * them at once, provided no thread is inserting.
+ */
+template <size_t FANOUT = 16>
+class BTreeStringSet {
+    static_assert(FANOUT >= 3,
+                  "a B+-tree node needs at least 3 children");
+
+ private:
+    struct Node;
+
+ public:
+    /**
+     * \class ConstIterator
+     * \brief A forward iterator over the keys, in ascending order.
+     *
+     * \details
+     * The keys aren't stored as std::strings, so dereferencing yields a
+     * std::string_view into the set.
+     */
+    class ConstIterator {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        ConstIterator() = default;
+        ConstIterator(const ConstIterator& other) = default;
+        ConstIterator& operator=(const ConstIterator& other) = default;
+        ~ConstIterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator& other) const;
+        bool operator!=(const ConstIterator& other) const;
+
+     private:
+        friend class BTreeStringSet;
+        ConstIterator(const Node* leaf, size_t index);
+
+        const Node* leaf_ = nullptr;  ///< nullptr at the end
+        size_t index_ = 0;
+    };
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    /**
+     * \brief Creates an empty set.
+     * \param useArena Allocate nodes from slabs the set owns rather than
+     *                 one at a time with new.
+     */
+    explicit BTreeStringSet(bool useArena = false);
+    ~BTreeStringSet();
+
+    // Copying isn't supported.
+    BTreeStringSet(const BTreeStringSet& other) = delete;
+    BTreeStringSet& operator=(const BTreeStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there).
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels of nodes (a lone leaf has height 1).
+     */
+    size_t height() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the tree's shape.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /**
+     * \struct Node
+     * \brief A leaf or interior node.  Both have room for one key (and
+     *        child) more than they may keep, so insertion can overfill a
+     *        node and then split it.
+     */
+    struct Node {
+        explicit Node(bool isLeaf);
+
+        bool leaf;
+        size_t numKeys = 0;
+        std::string_view keys[FANOUT];  ///< Into the set's chars_
+        Node* children[FANOUT + 1] = {};  ///< Interior nodes only
+        Node* next = nullptr;             ///< Leaves only
+    };
+
+    /**
+     * \brief Inserts into the subtree rooted at node.
+     * \param[out] separator If node had to split, the key that belongs
+     *                       between node and its new right sibling.
+     * \returns The new right sibling if node split, otherwise nullptr.
+     */
+    Node* insertHelper(Node* node, const std::string& word,
+                       std::string_view& separator, bool& added);
+
+    /**
+     * \brief Splits an overfull node, returning its new right sibling.
+     */
+    Node* split(Node* node, std::string_view& separator);
+
+    /**
+     * \brief Allocates an empty node, from the arena if there is one.
+     */
+    Node* newNode(bool isLeaf);
+
+    /**
+     * \brief Index of the child of an interior node that could hold word.
+     */
+    static size_t childIndex(const Node* node, const std::string& word);
+
+    static void destroy(Node* node);
+
+    void countNodes(const Node* node, size_t& leaves, size_t& interior) const;
+
+    bool useArena_;
+    SlabPool<Node> arena_;  ///< Unused unless useArena_
+    StringArena chars_;     ///< The keys' characters
+    Node* root_;
+    Node* firstLeaf_;  ///< Splits only add leaves to the right of this one.
+    size_t size_ = 0;
+    size_t height_ = 1;
+};
+
+#include "btreestringset-private.hpp"
+
+#endif  // BTREESTRINGSET_HPP_INCLUDED
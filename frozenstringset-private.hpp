@@ -0,0 +1,35 @@
+/**
+ * \file frozenstringset-private.hpp
+ *
+ * \brief Template implementation details for FrozenStringSet.
+ */
+
+#include <limits>
+#include <stdexcept>
+
+template <typename InputIter>
+FrozenStringSet::FrozenStringSet(InputIter first, InputIter last)
+    : FrozenStringSet(first, last, 1) {
+    // Nothing else to do.
+}
+
+template <typename InputIter>
+FrozenStringSet::FrozenStringSet(InputIter first, InputIter last,
+                                 size_t numThreads) {
+    std::vector<Slot> sortedSlots;
+    std::vector<char> chars;
+    for (; first != last; ++first) {
+        std::string_view word = *first;
+        if (word.size()
+            > std::numeric_limits<uint32_t>::max() - chars.size()) {
+            throw std::length_error("too many characters for 32-bit "
+                                    "offsets in a FrozenStringSet");
+        }
+        sortedSlots.push_back({prefixOf(word),
+                               static_cast<uint32_t>(chars.size()),
+                               static_cast<uint32_t>(word.size())});
+        chars.insert(chars.end(), word.begin(), word.end());
+    }
+    chars.shrink_to_fit();
+    layOut(sortedSlots, std::move(chars), numThreads);
+}
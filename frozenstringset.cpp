@@ -0,0 +1,437 @@
+/**
+ * \file frozenstringset.cpp
+ *
+ * \brief Implementation of FrozenStringSet.
+ */
+
+#include "frozenstringset.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+/// How many levels ahead of the current node exists() prefetches.  Four
+/// levels down, the 16 possible descendants of slot i are contiguous.
+constexpr size_t PREFETCH_LEVELS = 4;
+
+constexpr size_t CACHE_LINE_BYTES = 64;
+
+constexpr char SNAPSHOT_MAGIC[8] = {'M', 'S', 'P', 'F', 'R', 'O', 'Z', 'N'};
+constexpr uint32_t SNAPSHOT_VERSION = 2;  // 2 added cached key prefixes
+
+/// Written in native byte order, so a snapshot from a machine with the
+/// other byte order is recognized rather than misread.
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * \struct SnapshotHeader
+ * \brief Start of a snapshot file.  It is followed by the slots (including
+ *        the unused slot 0) and then the key bytes.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t version;
+    uint64_t numKeys;
+    uint64_t numChars;
+    uint64_t checksum;
+};
+
+/**
+ * \brief Extends a 64-bit FNV-1a hash with some more bytes.
+ */
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------
+// ConstIterator
+// ---------------------------------------------------------------------
+
+FrozenStringSet::ConstIterator::ConstIterator(const FrozenStringSet* set,
+                                              size_t index)
+    : set_{set}, index_{index} {
+    // Nothing else to do.
+}
+
+FrozenStringSet::ConstIterator::reference
+FrozenStringSet::ConstIterator::operator*() const {
+    return set_->keyAt(index_);
+}
+
+FrozenStringSet::ConstIterator& FrozenStringSet::ConstIterator::operator++() {
+    if (2 * index_ + 1 <= set_->size_) {
+        // The successor is the leftmost node of the right subtree.
+        index_ = 2 * index_ + 1;
+        while (2 * index_ <= set_->size_) {
+            index_ *= 2;
+        }
+    } else {
+        // Climb past every right turn and one left turn, as in exists().
+        index_ >>= __builtin_ffsl(~index_);
+    }
+    return *this;
+}
+
+FrozenStringSet::ConstIterator FrozenStringSet::ConstIterator::operator++(
+    int) {
+    ConstIterator old = *this;
+    ++*this;
+    return old;
+}
+
+bool FrozenStringSet::ConstIterator::operator==(
+    const ConstIterator& other) const {
+    return index_ == other.index_;
+}
+
+bool FrozenStringSet::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+    return index_ != other.index_;
+}
+
+// ---------------------------------------------------------------------
+// FrozenStringSet
+// ---------------------------------------------------------------------
+
+FrozenStringSet::FrozenStringSet() {
+    layOut(std::vector<Slot>(), std::vector<char>());
+}
+
+size_t FrozenStringSet::size() const {
+    return size_;
+}
+
+size_t FrozenStringSet::height() const {
+    size_t levels = 0;
+    for (size_t n = size_; n > 0; n >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+size_t FrozenStringSet::bytesUsed() const {
+    return (size_ + 1) * sizeof(Slot) + numChars_;
+}
+
+void FrozenStringSet::layOut(const std::vector<Slot>& sortedSlots,
+                             std::vector<char> chars, size_t numThreads) {
+    auto storage = std::make_shared<Storage>();
+    storage->slots.assign(sortedSlots.size() + 1, Slot{0, 0, 0});
+    storage->chars = std::move(chars);
+    size_ = sortedSlots.size();  // fill() needs subtreeSize()
+
+    // Fill in just enough levels at the top to leave a subtree below for
+    // each thread, then fill those subtrees in parallel.  They cover
+    // disjoint slots, and fill() worked out which keys each one gets.
+    size_t topLevels = 0;
+    while ((size_t(1) << topLevels) < numThreads) {
+        ++topLevels;
+    }
+    std::vector<Subtree> subtrees;
+    fill(storage->slots, sortedSlots, 0, 1, topLevels, subtrees);
+
+    auto fillSubtree = [&](const Subtree& subtree) {
+        std::vector<Subtree> none;
+        fill(storage->slots, sortedSlots, subtree.first, subtree.root,
+             std::numeric_limits<size_t>::max(), none);
+    };
+    std::vector<std::thread> workers;
+    for (size_t s = 1; s < subtrees.size(); ++s) {
+        workers.emplace_back(fillSubtree, subtrees[s]);
+    }
+    if (!subtrees.empty()) {
+        fillSubtree(subtrees[0]);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    slots_ = storage->slots.data();
+    chars_ = storage->chars.data();
+    numChars_ = storage->chars.size();
+    storage_ = std::move(storage);
+}
+
+size_t FrozenStringSet::fill(std::vector<Slot>& slots,
+                             const std::vector<Slot>& sortedSlots,
+                             size_t next, size_t i, size_t levels,
+                             std::vector<Subtree>& deferred) const {
+    if (i >= slots.size()) {
+        return next;
+    } else if (levels == 0) {
+        deferred.push_back({i, next});
+        return next + subtreeSize(i);
+    }
+    next = fill(slots, sortedSlots, next, 2 * i, levels - 1, deferred);
+    slots[i] = sortedSlots[next++];
+    return fill(slots, sortedSlots, next, 2 * i + 1, levels - 1, deferred);
+}
+
+std::string_view FrozenStringSet::keyAt(size_t i) const {
+    return std::string_view(chars_ + slots_[i].offset, slots_[i].length);
+}
+
+uint64_t FrozenStringSet::prefixOf(std::string_view word) {
+    uint64_t prefix = 0;
+    for (size_t k = 0; k < PREFIX_BYTES; ++k) {
+        unsigned char byte = k < word.size() ? word[k] : 0;
+        prefix = (prefix << 8) | byte;
+    }
+    return prefix;
+}
+
+int FrozenStringSet::compareAt(size_t i, std::string_view key,
+                               uint64_t keyPrefix, size_t& fullCompares) const {
+    const Slot& slot = slots_[i];
+    if (slot.prefix != keyPrefix) {
+        return slot.prefix < keyPrefix ? -1 : 1;
+    }
+    // Equal prefixes: if either string ends within them, it is a prefix of
+    // the other (which is zero-padded to match), so the lengths decide.
+    if (slot.length <= PREFIX_BYTES || key.size() <= PREFIX_BYTES) {
+        return slot.length < key.size() ? -1 : slot.length > key.size();
+    }
+    ++fullCompares;
+    return keyAt(i).substr(PREFIX_BYTES).compare(key.substr(PREFIX_BYTES));
+}
+
+bool FrozenStringSet::find(std::string_view key, size_t& compares,
+                           size_t& fullCompares) const {
+    const size_t n = size_;
+    const uint64_t keyPrefix = prefixOf(key);
+    size_t i = 1;
+    while (i <= n) {
+        size_t ahead = i << PREFETCH_LEVELS;
+        if (ahead <= n) {
+            // The descendants span several lines; ask for each.
+            const char* first = reinterpret_cast<const char*>(&slots_[ahead]);
+            for (size_t line = 0; line < sizeof(Slot) << PREFETCH_LEVELS;
+                 line += CACHE_LINE_BYTES) {
+                __builtin_prefetch(first + line);
+            }
+        }
+        // Go right when the key here is smaller, without branching on it.
+        ++compares;
+        i = 2 * i + (compareAt(i, key, keyPrefix, fullCompares) < 0);
+    }
+    // We went right at every level below the last node we went left at,
+    // which is the only candidate.  Strip those right turns (and that left
+    // turn) off i to get back to it; i becomes 0 if we never went left.
+    i >>= __builtin_ffsl(~i);
+    if (i == 0) {
+        return false;
+    }
+    ++compares;
+    return compareAt(i, key, keyPrefix, fullCompares) == 0;
+}
+
+bool FrozenStringSet::exists(const std::string& word) const {
+    // The counts are dropped, so the compiler drops the counting.
+    size_t compares = 0;
+    size_t fullCompares = 0;
+    return find(word, compares, fullCompares);
+}
+
+bool FrozenStringSet::existsCounting(const std::string& word,
+                                     CompareCounts& counts) const {
+    return find(word, counts.compares, counts.fullCompares);
+}
+
+FrozenStringSet::ConstIterator FrozenStringSet::begin() const {
+    if (size_ == 0) {
+        return end();
+    }
+    size_t i = 1;
+    while (2 * i <= size_) {
+        i *= 2;
+    }
+    return ConstIterator(this, i);
+}
+
+FrozenStringSet::ConstIterator FrozenStringSet::end() const {
+    return ConstIterator(this, 0);
+}
+
+size_t FrozenStringSet::subtreeSize(size_t i) const {
+    // Level by level, the subtree covers a run of indices that doubles in
+    // length, cut short at size_ on the bottom level.
+    size_t count = 0;
+    for (size_t first = i, width = 1; first <= size_; first *= 2, width *= 2) {
+        count += std::min(first + width - 1, size_) - first + 1;
+    }
+    return count;
+}
+
+std::string_view FrozenStringSet::select(size_t k) const {
+    size_t i = 1;
+    for (;;) {
+        size_t leftSize = subtreeSize(2 * i);
+        if (k == leftSize) {
+            return keyAt(i);
+        } else if (k < leftSize) {
+            i = 2 * i;
+        } else {
+            k -= leftSize + 1;
+            i = 2 * i + 1;
+        }
+    }
+}
+
+void FrozenStringSet::existsGroup(const std::string* words, size_t count,
+                                  bool* found) const {
+    size_t index[MAX_GROUP_SIZE];
+    uint64_t prefix[MAX_GROUP_SIZE];
+    for (size_t j = 0; j < count; ++j) {
+        index[j] = 1;
+        prefix[j] = prefixOf(words[j]);
+    }
+    size_t fullCompares = 0;  // Unused
+
+    // Every descent finishes within height() steps.
+    for (size_t level = height(); level > 0; --level) {
+        // Step each lookup down and ask for its next slot.  The cached
+        // prefixes mean the key bytes are rarely needed.
+        for (size_t j = 0; j < count; ++j) {
+            size_t i = index[j];
+            if (i <= size_) {
+                int order = compareAt(i, words[j], prefix[j], fullCompares);
+                i = 2 * i + (order < 0);
+                __builtin_prefetch(&slots_[std::min(i, size_)]);
+                index[j] = i;
+            }
+        }
+    }
+
+    // Back up to each lookup's candidate, as in exists().  It was passed
+    // on the way down, so it is already in the cache.
+    for (size_t j = 0; j < count; ++j) {
+        size_t i = index[j] >> __builtin_ffsl(~index[j]);
+        found[j] = i != 0
+                   && compareAt(i, words[j], prefix[j], fullCompares) == 0;
+    }
+}
+
+uint64_t FrozenStringSet::checksum() const {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = fnv1a(hash, slots_, (size_ + 1) * sizeof(Slot));
+    return fnv1a(hash, chars_, numChars_);
+}
+
+void FrozenStringSet::save(const std::string& filename) const {
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = SNAPSHOT_VERSION;
+    header.numKeys = size_;
+    header.numChars = numChars_;
+    header.checksum = checksum();
+
+    try {
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(filename, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(slots_),
+                  (size_ + 1) * sizeof(Slot));
+        out.write(chars_, numChars_);
+    } catch (std::system_error& e) {
+        // As in readWords, add the filename to the library's error.
+        throw std::system_error(
+            std::make_error_code(std::errc(errno)),
+            "Error writing '" + filename + "' (" + e.code().message() + ")");
+    }
+}
+
+FrozenStringSet FrozenStringSet::load(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Error opening '" + filename + "'");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Error examining '" + filename + "'");
+    }
+    size_t fileSize = info.st_size;
+    if (fileSize < sizeof(SnapshotHeader)) {
+        close(fd);
+        throw std::runtime_error("'" + filename + "' is not a snapshot");
+    }
+    void* base = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    close(fd);  // The mapping stays valid without the descriptor.
+    if (base == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(),
+                                "Error mapping '" + filename + "'");
+    }
+
+    FrozenStringSet set;
+    set.storage_ = std::shared_ptr<const void>(
+        base, [fileSize](const void* mapping) {
+            munmap(const_cast<void*>(mapping), fileSize);
+        });
+
+    const SnapshotHeader* header = static_cast<const SnapshotHeader*>(base);
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+        || header->byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("'" + filename + "' is not a snapshot");
+    }
+    if (header->version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("'" + filename
+                                 + "' is from an unsupported version");
+    }
+    // Bound the counts by what the file could hold before multiplying, so
+    // that a huge count can't wrap around to a plausible size.
+    size_t payloadBytes = fileSize - sizeof(SnapshotHeader);
+    if (header->numKeys >= payloadBytes / sizeof(Slot)
+        || header->numChars > payloadBytes) {
+        throw std::runtime_error("'" + filename + "' is truncated");
+    }
+    size_t slotBytes = (header->numKeys + 1) * sizeof(Slot);
+    if (payloadBytes != slotBytes + header->numChars) {
+        throw std::runtime_error("'" + filename + "' is truncated");
+    }
+
+    const char* bytes = static_cast<const char*>(base);
+    set.slots_ = reinterpret_cast<const Slot*>(bytes + sizeof(SnapshotHeader));
+    set.size_ = header->numKeys;
+    set.chars_ = bytes + sizeof(SnapshotHeader) + slotBytes;
+    set.numChars_ = header->numChars;
+    if (set.checksum() != header->checksum) {
+        throw std::runtime_error("'" + filename + "' is corrupt");
+    }
+    for (size_t i = 1; i <= set.size_; ++i) {
+        const Slot& slot = set.slots_[i];
+        if (uint64_t(slot.offset) + slot.length > set.numChars_) {
+            throw std::runtime_error("'" + filename + "' is corrupt");
+        }
+    }
+    return set;
+}
+
+void FrozenStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " keys in Eytzinger layout, height " << height() << ", "
+        << bytesUsed() << " bytes\n";
+}
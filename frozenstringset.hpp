@@ -0,0 +1,285 @@
+/**
+ * \file frozenstringset.hpp
+ *
+ * \brief A read-only string set stored as a flat array in Eytzinger order.
+ */
+
+#ifndef FROZENSTRINGSET_HPP_INCLUDED
+#define FROZENSTRINGSET_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \class FrozenStringSet
+ * \brief An immutable set of strings laid out for fast lookups.
+ *
+ * \details
+ * The keys are stored in breadth-first (Eytzinger) order, so the implicit
+ * binary search tree has its root at index 1 and the children of index i
+ * at 2i and 2i+1.  Descending the tree is then just index arithmetic, and
+ * the top levels of the tree share a handful of cache lines.  All key
+ * bytes live in one contiguous character arena; each slot holds an offset
+ * and a length into it, plus a copy of the key's first eight bytes packed
+ * into an integer.  Most comparisons are settled by comparing those
+ * integers, without touching the arena at all.
+ *
+ * A FrozenStringSet is built once from a sorted range of distinct strings
+ * (such as the in-order contents of a TreeStringSet) and never changes
+ * afterwards.  Because slots hold offsets rather than pointers, the whole
+ * set can be saved to a snapshot file and later used straight from a
+ * read-only memory mapping of that file.  Copies share the same storage.
+ *
+ * Nothing ever writes to a FrozenStringSet after it is built, so any
+ * number of threads may look things up in one at the same time.
+ */
+class FrozenStringSet {
+ public:
+    /**
+     * \class ConstIterator
+     * \brief A forward iterator over the keys, in ascending order.
+     *
+     * \details
+     * The keys aren't stored as std::strings, so dereferencing yields a
+     * std::string_view into the set.
+     */
+    class ConstIterator {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        ConstIterator() = default;
+        ConstIterator(const ConstIterator& other) = default;
+        ConstIterator& operator=(const ConstIterator& other) = default;
+        ~ConstIterator() = default;
+
+        reference operator*() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator& other) const;
+        bool operator!=(const ConstIterator& other) const;
+
+     private:
+        friend class FrozenStringSet;
+        ConstIterator(const FrozenStringSet* set, size_t index);
+
+        const FrozenStringSet* set_ = nullptr;
+        size_t index_ = 0;  ///< Eytzinger index; 0 at the end
+    };
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    /**
+     * \brief Creates an empty set.
+     */
+    FrozenStringSet();
+
+    /**
+     * \brief Creates a set holding the strings in [first, last).
+     * \param first Iterator to the first string.
+     * \param last  Iterator past the last string.
+     * \throws std::length_error if the strings total 4 GiB or more.
+     *
+     * \pre The strings are in ascending order with no duplicates.
+     */
+    template <typename InputIter>
+    FrozenStringSet(InputIter first, InputIter last);
+
+    /**
+     * \brief Creates a set holding the strings in [first, last), laying out
+     *        separate subtrees on separate threads.
+     * \param first Iterator to the first string.
+     * \param last  Iterator past the last string.
+     * \param numThreads How many threads to use.
+     * \throws std::length_error if the strings total 4 GiB or more.
+     *
+     * \pre The strings are in ascending order with no duplicates.
+     */
+    template <typename InputIter>
+    FrozenStringSet(InputIter first, InputIter last, size_t numThreads);
+
+    /**
+     * \brief Writes the set to a snapshot file that load() can map.
+     * \param filename The file to write.
+     * \throws std::system_error if the file can't be written.
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * \brief Maps a snapshot file written by save() into memory and uses it
+     *        in place, without copying or parsing the keys.
+     * \param filename The file to map.
+     * \throws std::system_error if the file can't be opened or mapped.
+     * \throws std::runtime_error if the file isn't an intact snapshot.
+     */
+    static FrozenStringSet load(const std::string& filename);
+
+    /// How a lookup's comparisons were settled (see existsCounting()).
+    struct CompareCounts {
+        size_t compares = 0;      ///< Key comparisons made
+        size_t fullCompares = 0;  ///< Ones the cached prefixes couldn't settle
+    };
+
+    /// Largest number of lookups existsGroup() can interleave.
+    static constexpr size_t MAX_GROUP_SIZE = 64;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels in the implicit tree (0 for an empty set).
+     */
+    size_t height() const;
+
+    /**
+     * \brief Total memory used by the slots and the character arena.
+     */
+    size_t bytesUsed() const;
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Looks for a string just as exists() does, but also tallies how
+     *        its comparisons were settled.
+     * \param word The string to look for.
+     * \param[in,out] counts The tallies to add to.
+     * \returns True if the word is in the set.
+     */
+    bool existsCounting(const std::string& word, CompareCounts& counts) const;
+
+    /**
+     * \brief Looks for several strings at once, stepping all their
+     *        descents down one level at a time.
+     * \param words Array of the strings to look for.
+     * \param count How many strings there are (at most MAX_GROUP_SIZE).
+     * \param[out] found Set to whether each string is in the set.
+     *
+     * \details
+     * Each descent is a chain of dependent cache misses.  Interleaving
+     * them lets every level prefetch the slot that each lookup needs
+     * next, so the misses of different lookups overlap instead of being
+     * waited out one at a time.
+     */
+    void existsGroup(const std::string* words, size_t count,
+                     bool* found) const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Finds the string with a given position in sorted order, in
+     *        O(log^2 n) time.
+     * \param k The position, counting from 0.
+     * \returns The k-th smallest string.
+     *
+     * \pre k < size()
+     */
+    std::string_view select(size_t k) const;
+
+    /**
+     * \brief Prints a one-line summary of the layout.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /// Number of leading key bytes cached in each slot.
+    static constexpr size_t PREFIX_BYTES = 8;
+
+    /// A key: its cached prefix, and where the whole key is in chars_.
+    struct Slot {
+        uint64_t prefix;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /// Storage for a set built in memory rather than mapped from a file.
+    struct Storage {
+        std::vector<Slot> slots;
+        std::vector<char> chars;
+    };
+
+    /// A subtree whose layout fill() has left for later.
+    struct Subtree {
+        size_t root;   ///< Index of its root
+        size_t first;  ///< Index in sortedSlots of its smallest key
+    };
+
+    /**
+     * \brief Takes over the key bytes and permutes sortedSlots into
+     *        Eytzinger order, using up to numThreads threads.
+     */
+    void layOut(const std::vector<Slot>& sortedSlots, std::vector<char> chars,
+                size_t numThreads = 1);
+
+    /**
+     * \brief In-order walk of the implicit tree rooted at index i, handing
+     *        out sortedSlots[next], sortedSlots[next+1], ... as it goes.
+     * \param levels How many levels to fill; the subtrees below them are
+     *               added to deferred instead.
+     * \returns The index of the next unused entry of sortedSlots.
+     */
+    size_t fill(std::vector<Slot>& slots, const std::vector<Slot>& sortedSlots,
+                size_t next, size_t i, size_t levels,
+                std::vector<Subtree>& deferred) const;
+
+    std::string_view keyAt(size_t i) const;
+
+    /**
+     * \brief The first PREFIX_BYTES of a string, big-endian, zero-padded, so
+     *        that unequal prefixes order the same way as their strings.
+     */
+    static uint64_t prefixOf(std::string_view word);
+
+    /**
+     * \brief Three-way comparison of the key at index i against key.
+     * \param keyPrefix prefixOf(key).
+     * \param[in,out] fullCompares Incremented if the cached prefix couldn't
+     *                             settle the comparison.
+     * \returns Negative, zero, or positive as the key at i is less than,
+     *          equal to, or greater than key.
+     */
+    int compareAt(size_t i, std::string_view key, uint64_t keyPrefix,
+                  size_t& fullCompares) const;
+
+    /**
+     * \brief The search behind exists() and existsCounting().
+     */
+    bool find(std::string_view key, size_t& compares,
+              size_t& fullCompares) const;
+
+    /**
+     * \brief Number of slots in the implicit subtree rooted at index i.
+     */
+    size_t subtreeSize(size_t i) const;
+
+    /// Checksum of the slots and key bytes, as stored in snapshots.
+    uint64_t checksum() const;
+
+    std::shared_ptr<const void> storage_;  ///< Owns what slots_/chars_ see
+    const Slot* slots_;   ///< Eytzinger order; slots_[0] is unused.
+    size_t size_;
+    const char* chars_;   ///< Key bytes, in sorted order.
+    size_t numChars_;
+};
+
+#include "frozenstringset-private.hpp"
+
+#endif  // FROZENSTRINGSET_HPP_INCLUDED
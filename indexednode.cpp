@@ -0,0 +1,255 @@
+/**
+ * \file indexednode.cpp
+ *
+ * \brief Implementation of NodeStore, KeyListIterator, and SortedKeyList.
+ */
+
+#include "indexednode.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// ---------------------------------------------------------------------
+// NodeStore
+// ---------------------------------------------------------------------
+
+NodeStore::NodeStore() : nodes_(1) {
+    nodes_[NONE] = IndexedNode{NONE, NONE, 0, 0, {}};
+}
+
+NodeIndex NodeStore::add(std::string_view key, NodeIndex left,
+                         NodeIndex right) {
+    if (nodes_.size() > std::numeric_limits<NodeIndex>::max()) {
+        throw std::length_error("too many nodes for 32-bit node indices");
+    }
+    if (key.size() > std::numeric_limits<uint32_t>::max() - arena_.size()) {
+        throw std::length_error("too many key bytes for 32-bit arena "
+                                "offsets");
+    }
+    IndexedNode node{left, right, uint32_t(key.size()), 0, {}};
+    if (key.size() <= IndexedNode::INLINE_BYTES) {
+        std::memcpy(node.chars, key.data(), key.size());
+    } else {
+        node.offset = uint32_t(arena_.size());
+        arena_.insert(arena_.end(), key.begin(), key.end());
+    }
+    nodes_.push_back(node);
+    return NodeIndex(nodes_.size() - 1);
+}
+
+NodeIndex NodeStore::insertLeaf(NodeIndex& root, std::string_view word,
+                                std::vector<NodeIndex>& path) {
+    path.clear();
+    NodeIndex parent = NONE;
+    int cmp = 0;
+    for (NodeIndex node = root; node != NONE;
+         node = cmp < 0 ? nodes_[node].left : nodes_[node].right) {
+        cmp = word.compare(key(node));
+        if (cmp == 0) {
+            return NONE;
+        }
+        path.push_back(node);
+        parent = node;
+    }
+
+    NodeIndex added = add(word, NONE, NONE);
+    if (parent == NONE) {
+        root = added;
+    } else if (cmp < 0) {
+        nodes_[parent].left = added;
+    } else {
+        nodes_[parent].right = added;
+    }
+    return added;
+}
+
+void NodeStore::assign(std::vector<std::string>&& words) {
+    std::vector<std::string> keys = std::move(words);
+    nodes_.resize(1);
+    nodes_.reserve(keys.size() + 1);
+    arena_.clear();
+    for (const auto& key : keys) {
+        add(key, NONE, NONE);
+    }
+}
+
+NodeIndex NodeStore::linkBalanced(NodeIndex first, NodeIndex last) {
+    if (first >= last) {
+        return NONE;
+    }
+    NodeIndex mid = first + (last - first) / 2;
+    nodes_[mid].left = linkBalanced(first, mid);
+    nodes_[mid].right = linkBalanced(mid + 1, last);
+    return mid;
+}
+
+size_t NodeStore::height(NodeIndex root) const {
+    size_t height = 0;
+    std::vector<std::pair<NodeIndex, size_t>> stack;  // (node, depth)
+    if (root != NONE) {
+        stack.emplace_back(root, 1);
+    }
+    while (!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+        height = std::max(height, depth);
+        if (nodes_[node].left != NONE) {
+            stack.emplace_back(nodes_[node].left, depth + 1);
+        }
+        if (nodes_[node].right != NONE) {
+            stack.emplace_back(nodes_[node].right, depth + 1);
+        }
+    }
+    return height;
+}
+
+void NodeStore::showBytes(std::ostream& out) const {
+    if (nodes_.size() <= 1) {
+        return;
+    }
+    size_t classicBytes = 0;
+    for (NodeIndex i = 1; i < nodes_.size(); ++i) {
+        // Count what a std::string of the key would have on the heap.
+        std::string copy(key(i));
+        const char* inside = reinterpret_cast<const char*>(&copy);
+        if (copy.data() < inside || copy.data() >= inside + sizeof(copy)) {
+            classicBytes += copy.capacity() + 1;
+        }
+        classicBytes += sizeof(std::string) + 2 * sizeof(void*);
+    }
+    size_t count = nodes_.size() - 1;
+    out << ", " << sizeof(IndexedNode) + double(arena_.size()) / count
+        << " bytes per node (" << double(classicBytes) / count
+        << " with std::string keys and pointer links)";
+}
+
+// ---------------------------------------------------------------------
+// KeyListIterator
+// ---------------------------------------------------------------------
+
+KeyListIterator::KeyListIterator(const std::string_view* current)
+    : current_{current} {
+    // Nothing else to do.
+}
+
+KeyListIterator::reference KeyListIterator::operator*() const {
+    return *current_;
+}
+
+KeyListIterator::pointer KeyListIterator::operator->() const {
+    return current_;
+}
+
+KeyListIterator::reference KeyListIterator::operator[](
+    difference_type n) const {
+    return current_[n];
+}
+
+KeyListIterator& KeyListIterator::operator++() {
+    ++current_;
+    return *this;
+}
+
+KeyListIterator KeyListIterator::operator++(int) {
+    KeyListIterator old = *this;
+    ++current_;
+    return old;
+}
+
+KeyListIterator& KeyListIterator::operator--() {
+    --current_;
+    return *this;
+}
+
+KeyListIterator KeyListIterator::operator--(int) {
+    KeyListIterator old = *this;
+    --current_;
+    return old;
+}
+
+KeyListIterator& KeyListIterator::operator+=(difference_type n) {
+    current_ += n;
+    return *this;
+}
+
+KeyListIterator& KeyListIterator::operator-=(difference_type n) {
+    current_ -= n;
+    return *this;
+}
+
+KeyListIterator KeyListIterator::operator+(difference_type n) const {
+    return KeyListIterator(current_ + n);
+}
+
+KeyListIterator KeyListIterator::operator-(difference_type n) const {
+    return KeyListIterator(current_ - n);
+}
+
+KeyListIterator::difference_type KeyListIterator::operator-(
+    const KeyListIterator& other) const {
+    return current_ - other.current_;
+}
+
+bool KeyListIterator::operator==(const KeyListIterator& other) const {
+    return current_ == other.current_;
+}
+
+bool KeyListIterator::operator!=(const KeyListIterator& other) const {
+    return current_ != other.current_;
+}
+
+bool KeyListIterator::operator<(const KeyListIterator& other) const {
+    return current_ < other.current_;
+}
+
+bool KeyListIterator::operator>(const KeyListIterator& other) const {
+    return current_ > other.current_;
+}
+
+bool KeyListIterator::operator<=(const KeyListIterator& other) const {
+    return current_ <= other.current_;
+}
+
+bool KeyListIterator::operator>=(const KeyListIterator& other) const {
+    return current_ >= other.current_;
+}
+
+// ---------------------------------------------------------------------
+// SortedKeyList
+// ---------------------------------------------------------------------
+
+void SortedKeyList::refresh(const NodeStore& nodes, NodeIndex root) const {
+    if (isCurrent_) {
+        return;
+    }
+    keys_.clear();
+    keys_.reserve(nodes.size() - 1);
+    std::vector<NodeIndex> stack;
+    for (NodeIndex node = root; node != NodeStore::NONE || !stack.empty();) {
+        if (node != NodeStore::NONE) {
+            stack.push_back(node);
+            node = nodes[node].left;
+        } else {
+            node = stack.back();
+            stack.pop_back();
+            keys_.push_back(nodes.key(node));
+            node = nodes[node].right;
+        }
+    }
+    isCurrent_ = true;
+}
+
+KeyListIterator SortedKeyList::begin(const NodeStore& nodes,
+                                     NodeIndex root) const {
+    refresh(nodes, root);
+    return KeyListIterator(keys_.data());
+}
+
+KeyListIterator SortedKeyList::end(const NodeStore& nodes,
+                                   NodeIndex root) const {
+    refresh(nodes, root);
+    return KeyListIterator(keys_.data() + keys_.size());
+}
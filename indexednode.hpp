@@ -0,0 +1,270 @@
+/**
+ * \file indexednode.hpp
+ *
+ * \brief The node type shared by the binary search trees that keep their
+ *        nodes in a vector, the vector they keep them in, and the sorted
+ *        key list they iterate through.
+ */
+
+#ifndef INDEXEDNODE_HPP_INCLUDED
+#define INDEXEDNODE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Position of a node in its tree's node vector.
+using NodeIndex = uint32_t;
+
+/**
+ * \struct IndexedNode
+ * \brief A binary search tree node exactly one cache line in size, whose
+ *        children are 32-bit indices into the vector holding all the tree's
+ *        nodes, rather than pointers.
+ *
+ * \details
+ * Keys of up to INLINE_BYTES bytes (nearly every dictionary word) are
+ * stored in the node itself, so comparing against one never touches
+ * memory outside the node's cache line.  Longer keys are spilled to a
+ * separate character arena, and the node records where.  Because links and
+ * spilled keys are positions rather than addresses, the nodes can be
+ * moved, grown, or written out as they are.
+ *
+ * The sets built from these nodes (SplayStringSet, ScapegoatStringSet,
+ * TreapStringSet, RedBlackStringSet) keep them all in one NodeStore, so a
+ * tree is one allocation (plus the arena) rather than one per node, and
+ * goes away in O(1) frees.
+ *
+ * Unless it reshapes the tree on lookups (as a splay tree does), a set's
+ * exists() only reads the tree, so several threads may call it at once,
+ * provided no thread is inserting.  Iteration goes through a SortedKeyList,
+ * though, whose begin() isn't safe to call from several threads at once.
+ */
+struct alignas(64) IndexedNode {
+    /// The longest key stored in the node itself.
+    static constexpr size_t INLINE_BYTES = 48;
+
+    NodeIndex left;
+    NodeIndex right;
+    uint32_t length;   ///< Of the key
+    uint32_t offset;   ///< Into the arena, if the key didn't fit in chars
+    char chars[INLINE_BYTES];
+};
+
+static_assert(sizeof(IndexedNode) == 64,
+              "an IndexedNode is one cache line");
+
+/**
+ * \class NodeStore
+ * \brief The nodes of a tree, with the arena for their long keys.
+ *
+ * \details
+ * Index NONE (0) holds a node with no key, so that trees can use it to
+ * mean "no node" (and, if they like, use that node as scratch space).
+ */
+class NodeStore {
+ public:
+    /// Index meaning "no node".
+    static constexpr NodeIndex NONE = 0;
+
+    NodeStore();
+
+    /**
+     * \brief Adds a node holding a copy of key.
+     * \returns The new node's index.
+     * \throws std::length_error if a NodeIndex can't number another node,
+     *         or the arena would outgrow its 32-bit offsets.
+     */
+    NodeIndex add(std::string_view key, NodeIndex left, NodeIndex right);
+
+    /**
+     * \brief Adds word as a leaf of the tree rooted at index root, unless
+     *        the tree already holds it.
+     * \param[in,out] root Becomes the new node if the tree was empty.
+     * \param[out] path The nodes from the root down to the new leaf's
+     *                  parent (or to the node holding word).
+     * \returns The new leaf's index, or NONE if word was already there.
+     * \throws std::length_error as add() does.
+     */
+    NodeIndex insertLeaf(NodeIndex& root, std::string_view word,
+                         std::vector<NodeIndex>& path);
+
+    /**
+     * \brief Replaces every node with one per word, numbered from 1 in the
+     *        words' order, none of them linked to any other.
+     * \param words The keys, which the vector gives up.
+     * \throws std::length_error as add() does.
+     */
+    void assign(std::vector<std::string>&& words);
+
+    /**
+     * \brief Links the nodes numbered [first, last), whose keys must be in
+     *        ascending order, into a tree of minimal height, without
+     *        comparing any keys.
+     * \returns The index of the tree's root (NONE if the range is empty).
+     */
+    NodeIndex linkBalanced(NodeIndex first, NodeIndex last);
+
+    IndexedNode& operator[](NodeIndex i) {
+        return nodes_[i];
+    }
+
+    const IndexedNode& operator[](NodeIndex i) const {
+        return nodes_[i];
+    }
+
+    /**
+     * \brief The key of the node at index i, valid until the next add().
+     */
+    std::string_view key(NodeIndex i) const {
+        const IndexedNode& node = nodes_[i];
+        return node.length <= IndexedNode::INLINE_BYTES
+                   ? std::string_view(node.chars, node.length)
+                   : std::string_view(arena_.data() + node.offset,
+                                      node.length);
+    }
+
+    /**
+     * \brief Looks for word in the tree rooted at index root.
+     * \param[in,out] compares Incremented once per key comparison.
+     * \returns The index of the node holding word, or NONE if there isn't
+     *          one.
+     */
+    NodeIndex find(NodeIndex root, std::string_view word,
+                   size_t& compares) const {
+        NodeIndex node = root;
+        while (node != NONE) {
+            int cmp = word.compare(key(node));
+            ++compares;
+            if (cmp == 0) {
+                break;
+            }
+            node = cmp < 0 ? nodes_[node].left : nodes_[node].right;
+        }
+        return node;
+    }
+
+    /**
+     * \brief Number of nodes, counting the one at index NONE.
+     */
+    size_t size() const {
+        return nodes_.size();
+    }
+
+    /**
+     * \brief Number of levels in the tree rooted at index root.
+     *
+     * \details
+     * Some trees can be as tall as they are big, so this walks the tree
+     * without recursion.
+     */
+    size_t height(NodeIndex root) const;
+
+    /**
+     * \brief Prints the memory the nodes use per node, counting the arena,
+     *        alongside what they would use as nodes holding a std::string
+     *        and two 64-bit pointers.
+     * \param out The stream to print to.
+     */
+    void showBytes(std::ostream& out) const;
+
+ private:
+    std::vector<IndexedNode> nodes_;
+    std::vector<char> arena_;  ///< The keys too long to go in their nodes
+};
+
+/**
+ * \class KeyListIterator
+ * \brief A random-access iterator over a list of keys held as
+ *        string_views.
+ *
+ * \details
+ * The keys in a NodeStore aren't std::strings, so dereferencing yields a
+ * std::string_view into the set.  The list is an array, so jumping ahead
+ * (to a quantile, say) takes constant time.
+ */
+class KeyListIterator {
+ public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    KeyListIterator() = default;
+    explicit KeyListIterator(const std::string_view* current);
+    KeyListIterator(const KeyListIterator& other) = default;
+    KeyListIterator& operator=(const KeyListIterator& other) = default;
+    ~KeyListIterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+    reference operator[](difference_type n) const;
+    KeyListIterator& operator++();
+    KeyListIterator operator++(int);
+    KeyListIterator& operator--();
+    KeyListIterator operator--(int);
+    KeyListIterator& operator+=(difference_type n);
+    KeyListIterator& operator-=(difference_type n);
+    KeyListIterator operator+(difference_type n) const;
+    KeyListIterator operator-(difference_type n) const;
+    difference_type operator-(const KeyListIterator& other) const;
+    bool operator==(const KeyListIterator& other) const;
+    bool operator!=(const KeyListIterator& other) const;
+    bool operator<(const KeyListIterator& other) const;
+    bool operator>(const KeyListIterator& other) const;
+    bool operator<=(const KeyListIterator& other) const;
+    bool operator>=(const KeyListIterator& other) const;
+
+    friend KeyListIterator operator+(difference_type n,
+                                     const KeyListIterator& iter) {
+        return iter + n;
+    }
+
+ private:
+    const std::string_view* current_ = nullptr;
+};
+
+/**
+ * \class SortedKeyList
+ * \brief The keys of a tree in a NodeStore, in ascending order, listed the
+ *        first time they're asked for after the tree gains a key.
+ *
+ * \details
+ * Rotations and rebuilds don't change the order, so only adding a key
+ * (which may also move every node) makes the list stale.  Because begin()
+ * may rebuild the list, it is not safe to call from several threads at
+ * once.
+ */
+class SortedKeyList {
+ public:
+    /**
+     * \brief Marks the list stale; call this after every NodeStore::add().
+     */
+    void invalidate() {
+        isCurrent_ = false;
+    }
+
+    /**
+     * \brief Iterators to the keys of the tree rooted at index root, listing
+     *        them first if need be.
+     */
+    KeyListIterator begin(const NodeStore& nodes, NodeIndex root) const;
+    KeyListIterator end(const NodeStore& nodes, NodeIndex root) const;
+
+ private:
+    /**
+     * \brief Lists the keys again (with an iterative in-order walk) if an
+     *        insert has made the list stale.
+     */
+    void refresh(const NodeStore& nodes, NodeIndex root) const;
+
+    mutable std::vector<std::string_view> keys_;
+    mutable bool isCurrent_ = true;
+};
+
+#endif  // INDEXEDNODE_HPP_INCLUDED
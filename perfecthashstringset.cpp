@@ -0,0 +1,251 @@
+/**
+ * \file perfecthashstringset.cpp
+ *
+ * \brief Implementation of PerfectHashStringSet.
+ */
+
+#include "perfecthashstringset.hpp"
+#include "stringhash.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/// Average number of keys per bucket.
+constexpr size_t BUCKET_SIZE = 5;
+
+/// Extra slots searched over, per 100 keys.
+constexpr size_t EXTRA_SLOTS_PERCENT = 1;
+
+/// Pilots tried for one bucket before giving up on the seed.
+constexpr uint32_t MAX_PILOT = 1u << 24;
+
+/// Maps a hash onto [0, range) without dividing (range must be < 2^32).
+size_t reduce(uint64_t hash, size_t range) {
+    return (uint64_t(uint32_t(hash >> 32)) * range) >> 32;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------
+// ConstIterator
+// ---------------------------------------------------------------------
+
+PerfectHashStringSet::ConstIterator::ConstIterator(const std::string* keys,
+                                                   const uint32_t* current)
+    : keys_{keys}, current_{current} {
+    // Nothing else to do.
+}
+
+PerfectHashStringSet::ConstIterator::reference
+PerfectHashStringSet::ConstIterator::operator*() const {
+    return keys_[*current_];
+}
+
+PerfectHashStringSet::ConstIterator::pointer
+PerfectHashStringSet::ConstIterator::operator->() const {
+    return &keys_[*current_];
+}
+
+PerfectHashStringSet::ConstIterator&
+PerfectHashStringSet::ConstIterator::operator++() {
+    ++current_;
+    return *this;
+}
+
+PerfectHashStringSet::ConstIterator
+PerfectHashStringSet::ConstIterator::operator++(int) {
+    ConstIterator old = *this;
+    ++current_;
+    return old;
+}
+
+bool PerfectHashStringSet::ConstIterator::operator==(
+    const ConstIterator& other) const {
+    return current_ == other.current_;
+}
+
+bool PerfectHashStringSet::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+    return current_ != other.current_;
+}
+
+// ---------------------------------------------------------------------
+// PerfectHashStringSet
+// ---------------------------------------------------------------------
+
+void PerfectHashStringSet::insert(const std::string& word) {
+    pending_.push_back(word);
+}
+
+size_t PerfectHashStringSet::size() const {
+    return keys_.size();
+}
+
+size_t PerfectHashStringSet::position(uint64_t hash, uint32_t pilot) const {
+    return reduce(mixHash(hash ^ mixHash(pilot + 1)), tableSize_);
+}
+
+size_t PerfectHashStringSet::slotFor(uint64_t hash) const {
+    size_t slot = position(hash, pilots_[reduce(hash, pilots_.size())]);
+    return slot < keys_.size() ? slot : remap_[slot - keys_.size()];
+}
+
+void PerfectHashStringSet::build() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Gather every key, old and new, in sorted order without duplicates.
+    for (size_t slot : sortedSlots_) {
+        pending_.push_back(std::move(keys_[slot]));
+    }
+    std::sort(pending_.begin(), pending_.end());
+    pending_.erase(std::unique(pending_.begin(), pending_.end()),
+                   pending_.end());
+
+    const size_t n = pending_.size();
+    tableSize_ = n + (n * EXTRA_SLOTS_PERCENT + 99) / 100;
+    pilots_.assign(std::max<size_t>(1, (n + BUCKET_SIZE - 1) / BUCKET_SIZE),
+                   0);
+
+    // Two different words can share a 64-bit hash, in which case no pilot
+    // can separate them; try another seed.
+    std::vector<uint64_t> hashes(n);
+    std::vector<uint32_t> slots(n);
+    for (seed_ = 0;; ++seed_) {
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = hashString(pending_[i], seed_);
+        }
+        if (findPilots(hashes, slots)) {
+            break;
+        }
+    }
+
+    // Give each slot past n the next hole below n.
+    std::vector<bool> taken(n, false);
+    for (uint32_t slot : slots) {
+        if (slot < n) {
+            taken[slot] = true;
+        }
+    }
+    remap_.assign(tableSize_ - n, 0);
+    size_t hole = 0;
+    for (uint32_t slot : slots) {
+        if (slot >= n) {
+            while (taken[hole]) {
+                ++hole;
+            }
+            remap_[slot - n] = hole++;
+        }
+    }
+
+    // Move each key into its slot.
+    keys_.assign(n, std::string());
+    sortedSlots_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t slot = slotFor(hashes[i]);
+        keys_[slot] = std::move(pending_[i]);
+        sortedSlots_[i] = slot;
+    }
+    pending_.clear();
+    pending_.shrink_to_fit();
+    built_ = true;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    buildSeconds_ = std::chrono::duration<double>(endTime - startTime).count();
+}
+
+bool PerfectHashStringSet::findPilots(const std::vector<uint64_t>& hashes,
+                                      std::vector<uint32_t>& slots) {
+    const size_t numBuckets = pilots_.size();
+
+    // Group the keys by bucket (a counting sort).
+    std::vector<size_t> bucketStart(numBuckets + 1, 0);
+    for (uint64_t hash : hashes) {
+        ++bucketStart[reduce(hash, numBuckets) + 1];
+    }
+    size_t largest = 0;
+    for (size_t b = 0; b < numBuckets; ++b) {
+        largest = std::max(largest, bucketStart[b + 1]);
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<uint32_t> members(hashes.size());
+    std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        members[fill[reduce(hashes[i], numBuckets)]++] = i;
+    }
+
+    // Place buckets biggest first.
+    std::vector<uint32_t> order(numBuckets);
+    for (size_t b = 0; b < numBuckets; ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&bucketStart](uint32_t lhs, uint32_t rhs) {
+                         return bucketStart[lhs + 1] - bucketStart[lhs]
+                                > bucketStart[rhs + 1] - bucketStart[rhs];
+                     });
+
+    std::vector<bool> taken(tableSize_, false);
+    std::vector<size_t> trial(largest);
+    for (uint32_t b : order) {
+        const size_t first = bucketStart[b];
+        const size_t count = bucketStart[b + 1] - first;
+        uint32_t pilot = 0;
+        for (;; ++pilot) {
+            if (pilot == MAX_PILOT) {
+                return false;
+            }
+            bool fits = true;
+            for (size_t k = 0; k < count && fits; ++k) {
+                trial[k] = position(hashes[members[first + k]], pilot);
+                fits = !taken[trial[k]]
+                       && std::find(trial.begin(), trial.begin() + k, trial[k])
+                              == trial.begin() + k;
+            }
+            if (fits) {
+                break;
+            }
+        }
+        pilots_[b] = pilot;
+        for (size_t k = 0; k < count; ++k) {
+            taken[trial[k]] = true;
+            slots[members[first + k]] = trial[k];
+        }
+    }
+    return true;
+}
+
+bool PerfectHashStringSet::exists(const std::string& word) const {
+    if (!built_) {
+        throw std::logic_error("PerfectHashStringSet used before build()");
+    }
+    if (keys_.empty()) {
+        return false;
+    }
+    return keys_[slotFor(hashString(word, seed_))] == word;
+}
+
+double PerfectHashStringSet::bitsPerKey() const {
+    if (keys_.empty()) {
+        return 0.0;
+    }
+    return 32.0 * (pilots_.size() + remap_.size()) / keys_.size();
+}
+
+PerfectHashStringSet::ConstIterator PerfectHashStringSet::begin() const {
+    return ConstIterator(keys_.data(), sortedSlots_.data());
+}
+
+PerfectHashStringSet::ConstIterator PerfectHashStringSet::end() const {
+    return ConstIterator(keys_.data(),
+                         sortedSlots_.data() + sortedSlots_.size());
+}
+
+void PerfectHashStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " keys in minimal perfect hash, " << pilots_.size()
+        << " buckets, " << bitsPerKey() << " bits/key, built in "
+        << buildSeconds_ << " seconds\n";
+}
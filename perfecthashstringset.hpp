@@ -0,0 +1,156 @@
+/**
+ * \file perfecthashstringset.hpp
+ *
+ * \brief A static string set indexed by a minimal perfect hash function.
+ */
+
+#ifndef PERFECTHASHSTRINGSET_HPP_INCLUDED
+#define PERFECTHASHSTRINGSET_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \class PerfectHashStringSet
+ * \brief A set of strings that is built all at once and then only read.
+ *
+ * \details
+ * Words given to insert() are just collected.  build() then finds a
+ * minimal perfect hash function for them, one that sends each of the n
+ * words to a different slot in [0, n), and stores each word in its slot.
+ * exists() computes the slot for a word and does one string compare.
+ *
+ * The hash function is "hash and displace" (as in PTHash): the words are
+ * split into buckets of about five by one hash, and each bucket gets a
+ * small number, its pilot, chosen during the build so that a second hash,
+ * seeded by the pilot, puts all the bucket's words into free slots.
+ * Buckets are placed biggest first, while free slots are plentiful.  The
+ * search runs over slightly more than n slots to keep the last pilots
+ * easy to find; the few words that land past n are then redirected into
+ * the holes below n through a small remapping table.
+ *
+ * exists() may only be used after build(); the words inserted since the
+ * last build() are not visible until the next one.  Between builds,
+ * exists() and iteration only read the set, so threads can share it.
+ */
+class PerfectHashStringSet {
+ public:
+    /**
+     * \class ConstIterator
+     * \brief A forward iterator over the keys, in ascending order.
+     */
+    class ConstIterator {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        ConstIterator() = default;
+        ConstIterator(const ConstIterator& other) = default;
+        ConstIterator& operator=(const ConstIterator& other) = default;
+        ~ConstIterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator& other) const;
+        bool operator!=(const ConstIterator& other) const;
+
+     private:
+        friend class PerfectHashStringSet;
+        ConstIterator(const std::string* keys, const uint32_t* current);
+
+        const std::string* keys_ = nullptr;
+        const uint32_t* current_ = nullptr;  ///< Into sortedSlots_
+    };
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    PerfectHashStringSet() = default;
+    ~PerfectHashStringSet() = default;
+
+    // Copying isn't supported.
+    PerfectHashStringSet(const PerfectHashStringSet& other) = delete;
+    PerfectHashStringSet& operator=(const PerfectHashStringSet& other) =
+        delete;
+
+    /**
+     * \brief Queues a string to be added by the next build().
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Builds the hash function over every word inserted so far.
+     */
+    void build();
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     * \throws std::logic_error if build() hasn't been called.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set as of the last build().
+     */
+    size_t size() const;
+
+    /**
+     * \brief Space taken by the hash function itself (not the keys).
+     */
+    double bitsPerKey() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the hash function.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /**
+     * \brief Tries to find pilots for every bucket using the current seed_.
+     * \param hashes The hash of each of the sorted, distinct keys.
+     * \param[out] slots The (pre-remapping) slot of each key.
+     * \returns False if some bucket couldn't be placed.
+     */
+    bool findPilots(const std::vector<uint64_t>& hashes,
+                    std::vector<uint32_t>& slots);
+
+    /**
+     * \brief Slot in [0, tableSize_) for a key hash and its bucket's pilot.
+     */
+    size_t position(uint64_t hash, uint32_t pilot) const;
+
+    /**
+     * \brief Slot in [0, size()) for a key hash.
+     */
+    size_t slotFor(uint64_t hash) const;
+
+    std::vector<std::string> pending_;   ///< Inserted since the last build
+    std::vector<std::string> keys_;      ///< Key in each slot
+    std::vector<uint32_t> sortedSlots_;  ///< Slots in ascending key order
+
+    std::vector<uint32_t> pilots_;  ///< One per bucket
+    std::vector<uint32_t> remap_;   ///< Home for slots [size(), tableSize_)
+    size_t tableSize_ = 0;
+    uint64_t seed_ = 0;
+    bool built_ = false;
+    double buildSeconds_ = 0.0;
+};
+
+#endif  // PERFECTHASHSTRINGSET_HPP_INCLUDED
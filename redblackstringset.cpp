@@ -0,0 +1,133 @@
+/**
+ * \file redblackstringset.cpp
+ *
+ * \brief Implementation of RedBlackStringSet.
+ */
+
+#include "redblackstringset.hpp"
+
+#include <utility>
+
+// ---------------------------------------------------------------------
+// RedBlackStringSet
+// ---------------------------------------------------------------------
+
+RedBlackStringSet::RedBlackStringSet() : red_(1, false) {
+    // nodes_[NONE] holds no key, and is black.
+}
+
+size_t RedBlackStringSet::size() const {
+    return nodes_.size() - 1;
+}
+
+bool RedBlackStringSet::exists(const std::string& word) const {
+    size_t compares = 0;
+    return nodes_.find(root_, word, compares) != NONE;
+}
+
+void RedBlackStringSet::insert(const std::string& word) {
+    // Add the word as a red leaf, remembering the path to it.
+    NodeIndex node = nodes_.insertLeaf(root_, word, path_);
+    if (node == NONE) {
+        return;
+    }
+    red_.push_back(true);
+    sorted_.invalidate();
+
+    // While node and its parent are both red, path_[k - 1] is the parent.
+    // The root is black, so a red parent always has a parent of its own.
+    size_t k = path_.size();
+    while (k >= 2 && red_[path_[k - 1]]) {
+        NodeIndex parent = path_[k - 1];
+        NodeIndex grandparent = path_[k - 2];
+        NodeIndex above = k >= 3 ? path_[k - 3] : NONE;
+        bool parentIsLeft = nodes_[grandparent].left == parent;
+        NodeIndex uncle = parentIsLeft ? nodes_[grandparent].right
+                                       : nodes_[grandparent].left;
+        if (red_[uncle]) {
+            // Push the grandparent's blackness down a level, and carry on
+            // from the grandparent, which is now red.
+            red_[parent] = false;
+            red_[uncle] = false;
+            red_[grandparent] = true;
+            node = grandparent;
+            k -= 2;
+            continue;
+        }
+
+        // A black uncle: one or two rotations bring the middle key of
+        // node, parent, and grandparent to the top, which ends the climb.
+        if ((nodes_[parent].left == node) != parentIsLeft) {
+            rotateUp(node, parent, grandparent);
+            std::swap(node, parent);
+        }
+        rotateUp(parent, grandparent, above);
+        red_[parent] = false;
+        red_[grandparent] = true;
+        break;
+    }
+    red_[root_] = false;
+}
+
+void RedBlackStringSet::buildFromSorted(std::vector<std::string>&& words) {
+    nodes_.assign(std::move(words));
+    red_.assign(nodes_.size(), false);
+    root_ = nodes_.linkBalanced(1, NodeIndex(nodes_.size()));
+    size_t height = nodes_.height(root_);
+    if (height > 1) {
+        colorLevel(root_, 1, height);
+    }
+    sorted_.invalidate();
+}
+
+void RedBlackStringSet::colorLevel(NodeIndex node, size_t depth,
+                                   size_t level) {
+    if (node == NONE) {
+        return;
+    }
+    if (depth == level) {
+        red_[node] = true;
+        return;
+    }
+    colorLevel(nodes_[node].left, depth + 1, level);
+    colorLevel(nodes_[node].right, depth + 1, level);
+}
+
+void RedBlackStringSet::rotateUp(NodeIndex child, NodeIndex parent,
+                                 NodeIndex above) {
+    if (nodes_[parent].left == child) {
+        nodes_[parent].left = nodes_[child].right;
+        nodes_[child].right = parent;
+    } else {
+        nodes_[parent].right = nodes_[child].left;
+        nodes_[child].left = parent;
+    }
+    ++rotations_;
+
+    if (above == NONE) {
+        root_ = child;
+    } else if (nodes_[above].left == parent) {
+        nodes_[above].left = child;
+    } else {
+        nodes_[above].right = child;
+    }
+}
+
+size_t RedBlackStringSet::height() const {
+    return nodes_.height(root_);
+}
+
+RedBlackStringSet::ConstIterator RedBlackStringSet::begin() const {
+    return sorted_.begin(nodes_, root_);
+}
+
+RedBlackStringSet::ConstIterator RedBlackStringSet::end() const {
+    return sorted_.end(nodes_, root_);
+}
+
+void RedBlackStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " nodes in red-black tree, height " << height() << ", "
+        << rotations_ << " rotations while inserting";
+    nodes_.showBytes(out);
+    out << "\n";
+}
@@ -0,0 +1,122 @@
+/**
+ * \file redblackstringset.hpp
+ *
+ * \brief A string set stored in a red-black tree.
+ */
+
+#ifndef REDBLACKSTRINGSET_HPP_INCLUDED
+#define REDBLACKSTRINGSET_HPP_INCLUDED
+
+#include "indexednode.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \class RedBlackStringSet
+ * \brief A binary search tree of strings that rebalances itself on every
+ *        insert, with the same interface as TreeStringSet.
+ *
+ * \details
+ * Each node is red or black; no red node has a red child, and every path
+ * from the root down to a missing child passes the same number of black
+ * nodes (Guibas and Sedgewick's red-black tree).  So no path is more than
+ * twice as long as any other, and the height stays below 2 log2(n + 1)
+ * whatever order the keys arrive in, sorted included.  An insert adds a
+ * red leaf, then walks back up its path recoloring, and ends with at most
+ * two rotations.
+ *
+ * Lookups never read the colors, so they're kept in a vector of bits
+ * beside the nodes rather than in them.  Nodes are IndexedNodes; see there
+ * for their layout and for which calls may run on several threads at once.
+ */
+class RedBlackStringSet {
+ public:
+    using ConstIterator = KeyListIterator;
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    RedBlackStringSet();
+    ~RedBlackStringSet() = default;
+
+    // Copying isn't supported.
+    RedBlackStringSet(const RedBlackStringSet& other) = delete;
+    RedBlackStringSet& operator=(const RedBlackStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there).
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Replaces the set's contents with sorted, distinct words, linked
+     *        straight into a tree of minimal height in O(n) time without
+     *        comparing any keys.
+     *
+     * \details
+     * Every level of such a tree but the last is full, so coloring the
+     * last level red and the rest black makes it a valid red-black tree.
+     *
+     * \param words The words, in ascending order with no repeats; the
+     *        vector gives them up.
+     */
+    void buildFromSorted(std::vector<std::string>&& words);
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels in the tree.
+     */
+    size_t height() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the tree's shape and of the
+     *        rotations it took to keep it that way.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /// Index meaning "no node"; it counts as black.
+    static constexpr NodeIndex NONE = NodeStore::NONE;
+
+    /**
+     * \brief Rotates the node at index child above its parent.
+     * \param above The parent's parent, or NONE if the parent is the root.
+     */
+    void rotateUp(NodeIndex child, NodeIndex parent, NodeIndex above);
+
+    /**
+     * \brief Colors red the nodes at the given level (counting the root as
+     *        level 1) of the subtree rooted at index node.
+     * \param depth The level node is at.
+     */
+    void colorLevel(NodeIndex node, size_t depth, size_t level);
+
+    NodeStore nodes_;
+    std::vector<bool> red_;  ///< Indexed like nodes_
+    NodeIndex root_ = NONE;
+    size_t rotations_ = 0;
+
+    std::vector<NodeIndex> path_;  ///< Scratch space for insert()
+
+    SortedKeyList sorted_;
+};
+
+#endif  // REDBLACKSTRINGSET_HPP_INCLUDED
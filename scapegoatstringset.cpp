@@ -0,0 +1,147 @@
+/**
+ * \file scapegoatstringset.cpp
+ *
+ * \brief Implementation of ScapegoatStringSet.
+ */
+
+#include "scapegoatstringset.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// ---------------------------------------------------------------------
+// ScapegoatStringSet
+// ---------------------------------------------------------------------
+
+ScapegoatStringSet::ScapegoatStringSet(double alpha)
+    : alpha_{alpha}, logInverseAlpha_{-std::log(alpha)} {
+    if (!(alpha > 0.5 && alpha < 1.0)) {
+        throw std::invalid_argument("scapegoat alpha must be in (0.5, 1)");
+    }
+}
+
+size_t ScapegoatStringSet::size() const {
+    return nodes_.size() - 1;
+}
+
+bool ScapegoatStringSet::exists(const std::string& word) const {
+    size_t compares = 0;
+    return nodes_.find(root_, word, compares) != NONE;
+}
+
+void ScapegoatStringSet::insert(const std::string& word) {
+    // Find where the word goes, remembering the path there.
+    NodeIndex added = nodes_.insertLeaf(root_, word, path_);
+    if (added == NONE) {
+        return;
+    }
+    sorted_.invalidate();
+
+    size_t depth = path_.size();
+    if (depth <= std::log(double(size())) / logInverseAlpha_) {
+        return;
+    }
+
+    // Too deep, so some ancestor must be out of balance.  Find the lowest
+    // one and rebuild it.
+    NodeIndex child = added;
+    size_t childSize = 1;
+    for (size_t k = path_.size(); k-- > 0;) {
+        NodeIndex ancestor = path_[k];
+        NodeIndex sibling = nodes_[ancestor].left == child
+                             ? nodes_[ancestor].right
+                             : nodes_[ancestor].left;
+        size_t ancestorSize = childSize + 1 + subtreeSize(sibling);
+        if (childSize > alpha_ * ancestorSize) {
+            NodeIndex top = rebuild(ancestor, ancestorSize);
+            if (k == 0) {
+                root_ = top;
+            } else if (nodes_[path_[k - 1]].left == ancestor) {
+                nodes_[path_[k - 1]].left = top;
+            } else {
+                nodes_[path_[k - 1]].right = top;
+            }
+            return;
+        }
+        child = ancestor;
+        childSize = ancestorSize;
+    }
+}
+
+void ScapegoatStringSet::buildFromSorted(std::vector<std::string>&& words) {
+    nodes_.assign(std::move(words));
+    root_ = nodes_.linkBalanced(1, NodeIndex(nodes_.size()));
+    sorted_.invalidate();
+}
+
+size_t ScapegoatStringSet::subtreeSize(NodeIndex i) {
+    size_t size = 0;
+    stack_.clear();
+    if (i != NONE) {
+        stack_.push_back(i);
+    }
+    while (!stack_.empty()) {
+        NodeIndex node = stack_.back();
+        stack_.pop_back();
+        ++size;
+        if (nodes_[node].left != NONE) {
+            stack_.push_back(nodes_[node].left);
+        }
+        if (nodes_[node].right != NONE) {
+            stack_.push_back(nodes_[node].right);
+        }
+    }
+    return size;
+}
+
+NodeIndex ScapegoatStringSet::rebuild(NodeIndex top, size_t size) {
+    inOrder_.clear();
+    inOrder_.reserve(size);
+    stack_.clear();
+    for (NodeIndex node = top; node != NONE || !stack_.empty();) {
+        if (node != NONE) {
+            stack_.push_back(node);
+            node = nodes_[node].left;
+        } else {
+            node = stack_.back();
+            stack_.pop_back();
+            inOrder_.push_back(node);
+            node = nodes_[node].right;
+        }
+    }
+    ++rebuilds_;
+    nodesRebuilt_ += size;
+    return buildBalanced(0, inOrder_.size());
+}
+
+NodeIndex ScapegoatStringSet::buildBalanced(size_t first, size_t last) {
+    if (first >= last) {
+        return NONE;
+    }
+    size_t mid = first + (last - first) / 2;
+    NodeIndex node = inOrder_[mid];
+    nodes_[node].left = buildBalanced(first, mid);
+    nodes_[node].right = buildBalanced(mid + 1, last);
+    return node;
+}
+
+size_t ScapegoatStringSet::height() const {
+    return nodes_.height(root_);
+}
+
+ScapegoatStringSet::ConstIterator ScapegoatStringSet::begin() const {
+    return sorted_.begin(nodes_, root_);
+}
+
+ScapegoatStringSet::ConstIterator ScapegoatStringSet::end() const {
+    return sorted_.end(nodes_, root_);
+}
+
+void ScapegoatStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " nodes in scapegoat tree (alpha " << alpha_
+        << "), height " << height() << ", " << rebuilds_
+        << " subtree rebuilds totalling " << nodesRebuilt_ << " nodes";
+    nodes_.showBytes(out);
+    out << "\n";
+}
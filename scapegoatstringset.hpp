@@ -0,0 +1,137 @@
+/**
+ * \file scapegoatstringset.hpp
+ *
+ * \brief A string set stored in a scapegoat tree.
+ */
+
+#ifndef SCAPEGOATSTRINGSET_HPP_INCLUDED
+#define SCAPEGOATSTRINGSET_HPP_INCLUDED
+
+#include "indexednode.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \class ScapegoatStringSet
+ * \brief A binary search tree of strings that stays within a constant
+ *        factor of perfect balance, with the same interface as
+ *        TreeStringSet.
+ *
+ * \details
+ * Nodes hold only a key and two child links: no colors, heights, or
+ * subtree sizes.  Instead, whenever an insert puts a node deeper than
+ * log_{1/alpha}(n), the tree walks back up the new node's path to find a
+ * "scapegoat", an ancestor with one child holding more than alpha of its
+ * subtree's nodes, and rebuilds that subtree into perfect balance
+ * (Galperin and Rivest's scapegoat tree).  Inserts take amortized
+ * O(log n) time, and no lookup compares more than log_{1/alpha}(n) + 1
+ * keys.  Alpha ranges over (0.5, 1): smaller values keep the tree shorter
+ * at the cost of more frequent rebuilding.
+ *
+ * Nodes are IndexedNodes; see there for their layout and for which calls
+ * may run on several threads at once.
+ */
+class ScapegoatStringSet {
+ public:
+    using ConstIterator = KeyListIterator;
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    /// The balance factor used unless another is given.
+    static constexpr double DEFAULT_ALPHA = 0.7;
+
+    /**
+     * \brief Creates an empty set.
+     * \param alpha How unbalanced a subtree may get before it's rebuilt.
+     * \throws std::invalid_argument unless 0.5 < alpha < 1.
+     */
+    explicit ScapegoatStringSet(double alpha = DEFAULT_ALPHA);
+    ~ScapegoatStringSet() = default;
+
+    // Copying isn't supported.
+    ScapegoatStringSet(const ScapegoatStringSet& other) = delete;
+    ScapegoatStringSet& operator=(const ScapegoatStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there).
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Replaces the set's contents with sorted, distinct words, linked
+     *        in O(n) time into the perfectly balanced shape rebuild() would
+     *        give them.
+     * \param words The words, in ascending order with no repeats; the
+     *        vector gives them up.
+     */
+    void buildFromSorted(std::vector<std::string>&& words);
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels in the tree.
+     */
+    size_t height() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the tree's shape and of the
+     *        rebuilding it took to keep it that way.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /// Index meaning "no node"; nodes_[NONE] is never used.
+    static constexpr NodeIndex NONE = NodeStore::NONE;
+
+    /**
+     * \brief Number of nodes in the subtree rooted at index i.
+     */
+    size_t subtreeSize(NodeIndex i);
+
+    /**
+     * \brief Rebuilds the subtree rooted at index top into perfect balance.
+     * \param size How many nodes it has.
+     * \returns The index of the rebuilt subtree's root.
+     */
+    NodeIndex rebuild(NodeIndex top, size_t size);
+
+    /**
+     * \brief Links inOrder_[first, last) into a perfectly balanced subtree.
+     * \returns The index of its root.
+     */
+    NodeIndex buildBalanced(size_t first, size_t last);
+
+    double alpha_;
+    double logInverseAlpha_;  ///< log(1 / alpha_)
+    NodeStore nodes_;
+    NodeIndex root_ = NONE;
+
+    size_t rebuilds_ = 0;
+    size_t nodesRebuilt_ = 0;
+
+    std::vector<NodeIndex> path_;     ///< Scratch space for insert()
+    std::vector<NodeIndex> inOrder_;  ///< Scratch space for rebuild()
+    std::vector<NodeIndex> stack_;    ///< For subtreeSize() and rebuild()
+
+    SortedKeyList sorted_;
+};
+
+#endif  // SCAPEGOATSTRINGSET_HPP_INCLUDED
@@ -0,0 +1,37 @@
+/**
+ * \file slabpool-private.hpp
+ *
+ * \brief Implementation of SlabPool.
+ */
+
+#include <new>
+#include <utility>
+
+template <typename T>
+SlabPool<T>::~SlabPool() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (size_t s = 0; s < slabs_.size(); ++s) {
+            size_t count = s + 1 < slabs_.size() ? SLAB_OBJECTS : used_;
+            for (size_t i = 0; i < count; ++i) {
+                std::launder(reinterpret_cast<T*>(&slabs_[s][i]))->~T();
+            }
+        }
+    }
+}
+
+template <typename T>
+template <typename... Args>
+T* SlabPool<T>::make(Args&&... args) {
+    if (used_ == SLAB_OBJECTS) {
+        slabs_.emplace_back(new Storage[SLAB_OBJECTS]);
+        used_ = 0;
+    }
+    T* object = new (&slabs_.back()[used_]) T(std::forward<Args>(args)...);
+    ++used_;
+    return object;
+}
+
+template <typename T>
+size_t SlabPool<T>::slabs() const {
+    return slabs_.size();
+}
@@ -0,0 +1,65 @@
+/**
+ * \file slabpool.hpp
+ *
+ * \brief An arena that hands out objects of one type from large slabs.
+ */
+
+#ifndef SLABPOOL_HPP_INCLUDED
+#define SLABPOOL_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \class SlabPool
+ * \brief Allocates objects of type T one after another in slabs of
+ *        SLAB_OBJECTS, and frees them all at once when it's destroyed.
+ *
+ * \tparam T The type of object to allocate.
+ *
+ * \details
+ * Making an object is a pointer bump, except once per slab, and objects
+ * made one after another sit next to each other in memory.  There's no way
+ * to free a single object.  Destroying the pool runs the objects'
+ * destructors slab by slab (not at all, if T's destructor is trivial) and
+ * then frees the slabs, so it costs a handful of calls to free() however
+ * many objects there are.
+ */
+template <typename T>
+class SlabPool {
+ public:
+    /// Objects per slab.
+    static constexpr size_t SLAB_OBJECTS = 256;
+
+    SlabPool() = default;
+    ~SlabPool();
+
+    // Copying isn't supported.
+    SlabPool(const SlabPool& other) = delete;
+    SlabPool& operator=(const SlabPool& other) = delete;
+
+    /**
+     * \brief Constructs a T in the pool.
+     * \param args Passed to T's constructor.
+     * \returns The new object, which lives as long as the pool does.
+     */
+    template <typename... Args>
+    T* make(Args&&... args);
+
+    /**
+     * \brief Number of slabs allocated so far.
+     */
+    size_t slabs() const;
+
+ private:
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    std::vector<std::unique_ptr<Storage[]>> slabs_;
+    size_t used_ = SLAB_OBJECTS;  ///< Objects made in the last slab
+};
+
+#include "slabpool-private.hpp"
+
+#endif  // SLABPOOL_HPP_INCLUDED
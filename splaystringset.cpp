@@ -0,0 +1,199 @@
+/**
+ * \file splaystringset.cpp
+ *
+ * \brief Implementation of SplayStringSet.
+ */
+
+#include "splaystringset.hpp"
+
+#include <utility>
+
+// ---------------------------------------------------------------------
+// SplayStringSet
+// ---------------------------------------------------------------------
+
+SplayStringSet::SplayStringSet() {
+    // nodes_[NONE] is the header, which holds no key.
+}
+
+size_t SplayStringSet::size() const {
+    return nodes_.size() - 1;
+}
+
+size_t SplayStringSet::lookups() const {
+    return lookups_;
+}
+
+size_t SplayStringSet::lookupCompares() const {
+    return lookupCompares_;
+}
+
+int SplayStringSet::splay(const std::string& word, size_t& compares) const {
+    // The header's right child collects the left tree (keys less than
+    // word) and its left child the right tree; leftMax and rightMin are
+    // where the next node joins each one.
+    IndexedNode& header = nodes_[NONE];
+    header.left = header.right = NONE;
+    NodeIndex leftMax = NONE;
+    NodeIndex rightMin = NONE;
+    NodeIndex t = root_;
+    int cmp;
+    for (;;) {
+        cmp = word.compare(nodes_.key(t));
+        ++compares;
+        if (cmp < 0) {
+            NodeIndex child = nodes_[t].left;
+            if (child == NONE) {
+                break;
+            }
+            ++compares;
+            if (word.compare(nodes_.key(child)) < 0) {
+                // Zig-zig: rotate right before linking.
+                nodes_[t].left = nodes_[child].right;
+                nodes_[child].right = t;
+                t = child;
+                if (nodes_[t].left == NONE) {
+                    break;
+                }
+            }
+            nodes_[rightMin].left = t;
+            rightMin = t;
+            t = nodes_[t].left;
+        } else if (cmp > 0) {
+            NodeIndex child = nodes_[t].right;
+            if (child == NONE) {
+                break;
+            }
+            ++compares;
+            if (word.compare(nodes_.key(child)) > 0) {
+                // Zag-zag: rotate left before linking.
+                nodes_[t].right = nodes_[child].left;
+                nodes_[child].left = t;
+                t = child;
+                if (nodes_[t].right == NONE) {
+                    break;
+                }
+            }
+            nodes_[leftMax].right = t;
+            leftMax = t;
+            t = nodes_[t].right;
+        } else {
+            break;
+        }
+    }
+
+    // Reassemble, with t at the root.
+    nodes_[leftMax].right = nodes_[t].left;
+    nodes_[rightMin].left = nodes_[t].right;
+    nodes_[t].left = header.right;
+    nodes_[t].right = header.left;
+    root_ = t;
+
+    // If a zig-zig ended the loop, cmp compared word with t's old parent,
+    // but word falls on the same side of t.
+    return cmp;
+}
+
+bool SplayStringSet::exists(const std::string& word) const {
+    ++lookups_;
+    if (root_ == NONE) {
+        return false;
+    }
+    return splay(word, lookupCompares_) == 0;
+}
+
+void SplayStringSet::insert(const std::string& word) {
+    NodeIndex left = NONE;
+    NodeIndex right = NONE;
+    if (root_ != NONE) {
+        size_t compares = 0;
+        int cmp = splay(word, compares);
+        if (cmp == 0) {
+            return;
+        }
+        IndexedNode& root = nodes_[root_];
+        if (cmp < 0) {
+            left = root.left;
+            right = root_;
+            root.left = NONE;
+        } else {
+            right = root.right;
+            left = root_;
+            root.right = NONE;
+        }
+    }
+    root_ = nodes_.add(word, left, right);
+    sorted_.invalidate();
+}
+
+void SplayStringSet::buildFromSorted(std::vector<std::string>&& words) {
+    nodes_.assign(std::move(words));
+    root_ = nodes_.linkBalanced(1, NodeIndex(nodes_.size()));
+    sorted_.invalidate();
+}
+
+void SplayStringSet::rebalance() {
+    // The header stands in as the parent of the root throughout.
+    IndexedNode& header = nodes_[NONE];
+    header.right = root_;
+
+    // Tree to vine: rotate right until no node on the spine has a left
+    // child.
+    NodeIndex tail = NONE;
+    NodeIndex rest = root_;
+    while (rest != NONE) {
+        NodeIndex left = nodes_[rest].left;
+        if (left == NONE) {
+            tail = rest;
+            rest = nodes_[rest].right;
+        } else {
+            nodes_[rest].left = nodes_[left].right;
+            nodes_[left].right = rest;
+            rest = left;
+            nodes_[tail].right = left;
+        }
+    }
+
+    // Vine to tree: first fold away the nodes that won't fit in a perfect
+    // tree (they become the bottom level), then halve the spine each round.
+    size_t n = size();
+    size_t perfect = 1;
+    while (perfect * 2 <= n + 1) {
+        perfect *= 2;
+    }
+    compress(NONE, n + 1 - perfect);
+    for (size_t spine = perfect - 1; spine > 1; spine /= 2) {
+        compress(NONE, spine / 2);
+    }
+    root_ = header.right;
+}
+
+void SplayStringSet::compress(NodeIndex top, size_t count) {
+    NodeIndex scanner = top;
+    for (size_t i = 0; i < count; ++i) {
+        // Rotate left at child, which is scanner's right child.
+        NodeIndex child = nodes_[scanner].right;
+        nodes_[scanner].right = nodes_[child].right;
+        scanner = nodes_[scanner].right;
+        nodes_[child].right = nodes_[scanner].left;
+        nodes_[scanner].left = child;
+    }
+}
+
+size_t SplayStringSet::height() const {
+    return nodes_.height(root_);
+}
+
+SplayStringSet::ConstIterator SplayStringSet::begin() const {
+    return sorted_.begin(nodes_, root_);
+}
+
+SplayStringSet::ConstIterator SplayStringSet::end() const {
+    return sorted_.end(nodes_, root_);
+}
+
+void SplayStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " nodes in splay tree, height " << height();
+    nodes_.showBytes(out);
+    out << "\n";
+}
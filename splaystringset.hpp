@@ -0,0 +1,150 @@
+/**
+ * \file splaystringset.hpp
+ *
+ * \brief A string set stored in a self-adjusting (splay) binary search tree.
+ */
+
+#ifndef SPLAYSTRINGSET_HPP_INCLUDED
+#define SPLAYSTRINGSET_HPP_INCLUDED
+
+#include "indexednode.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \class SplayStringSet
+ * \brief A binary search tree of strings that moves each key it finds to
+ *        the root, with the same interface as TreeStringSet.
+ *
+ * \details
+ * Every insert and every lookup splays the tree top-down (Sleator and
+ * Tarjan's splay operation) so that the last key on its search path ends
+ * up at the root, roughly halving the depth of the keys along the way.
+ * No single lookup is guaranteed to be fast, but a run of lookups costs
+ * about as much as it would in the best static tree for that run.  In
+ * text, where a few words ("the", "of", "and") make up much of every
+ * document, the common words stay near the root and are found in a
+ * comparison or two.
+ *
+ * Nodes are IndexedNodes (see there for their layout).  Because exists()
+ * reshapes the tree, it is const only in the sense that it doesn't change
+ * which strings are in the set.  Unlike the other sets built from
+ * IndexedNodes, a SplayStringSet can't be searched from several threads
+ * at once.
+ */
+class SplayStringSet {
+ public:
+    using ConstIterator = KeyListIterator;
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    SplayStringSet();
+    ~SplayStringSet() = default;
+
+    // Copying isn't supported.
+    SplayStringSet(const SplayStringSet& other) = delete;
+    SplayStringSet& operator=(const SplayStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there),
+     *        and splays it to the root.
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Replaces the set's contents with sorted, distinct words, linked
+     *        straight into a tree of minimal height in O(n) time without
+     *        comparing any keys.
+     * \param words The words, in ascending order with no repeats; the
+     *        vector gives them up.
+     */
+    void buildFromSorted(std::vector<std::string>&& words);
+
+    /**
+     * \brief Looks for a string in the set, splaying it (or, if it's
+     *        missing, the last key compared with it) to the root.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Reshapes the tree into one of minimal height, in O(n) time and
+     *        O(1) extra space (Day, Stout, and Warren's algorithm).
+     *
+     * \details
+     * Right rotations first straighten the tree into a "vine" (a sorted
+     * linked list down the right children); then rounds of left rotations
+     * at every other node fold the vine in half until it's balanced.
+     * Later lookups will splay it out of balance again, of course, but
+     * that takes time; this fixes a tree that inserting sorted words has
+     * left as a single path.
+     */
+    void rebalance();
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels in the tree, as it is shaped right now.
+     */
+    size_t height() const;
+
+    /**
+     * \brief Number of calls to exists() so far.
+     */
+    size_t lookups() const;
+
+    /**
+     * \brief Number of key comparisons made by all the calls to exists()
+     *        so far.
+     */
+    size_t lookupCompares() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the tree's current shape.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /// Index meaning "no node".  nodes_[NONE] isn't a key; splay() uses it
+    /// as the header that collects the left and right trees it builds.
+    static constexpr NodeIndex NONE = NodeStore::NONE;
+
+    /**
+     * \brief Splays the tree around word, leaving at the root either word
+     *        or the last key the search compared it with.
+     * \param[in,out] compares Incremented once per key comparison.
+     * \returns Negative, zero, or positive as word is less than, equal to,
+     *          or greater than the key now at the root.
+     *
+     * \pre The tree isn't empty.
+     */
+    int splay(const std::string& word, size_t& compares) const;
+
+    /**
+     * \brief Does count left rotations down the right spine below the
+     *        node at index top, one at every other node.
+     */
+    void compress(NodeIndex top, size_t count);
+
+    mutable NodeStore nodes_;  ///< nodes_[0] is splay()'s header
+    mutable NodeIndex root_ = NONE;
+
+    mutable size_t lookups_ = 0;
+    mutable size_t lookupCompares_ = 0;
+
+    SortedKeyList sorted_;
+};
+
+#endif  // SPLAYSTRINGSET_HPP_INCLUDED
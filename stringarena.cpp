@@ -0,0 +1,36 @@
+/**
+ * \file stringarena.cpp
+ *
+ * \brief Implementation of StringArena.
+ */
+
+#include "stringarena.hpp"
+
+#include <cstring>
+
+std::string_view StringArena::add(std::string_view chars) {
+    if (chars.empty()) {
+        return std::string_view();
+    }
+    char* copy;
+    if (chars.size() > BLOCK_BYTES) {
+        // Keep the partly used block last, so later strings can still use
+        // the rest of it.
+        auto where = blocks_.empty() ? blocks_.end() : blocks_.end() - 1;
+        copy = blocks_.emplace(where, new char[chars.size()])->get();
+    } else {
+        if (chars.size() > BLOCK_BYTES - blockUsed_) {
+            blocks_.emplace_back(new char[BLOCK_BYTES]);
+            blockUsed_ = 0;
+        }
+        copy = blocks_.back().get() + blockUsed_;
+        blockUsed_ += chars.size();
+    }
+    std::memcpy(copy, chars.data(), chars.size());
+    bytesUsed_ += chars.size();
+    return std::string_view(copy, chars.size());
+}
+
+size_t StringArena::bytesUsed() const {
+    return bytesUsed_;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file stringarena.hpp
+ *
+ * \brief Append-only storage for the characters of many strings.
+ */
+
+#ifndef STRINGARENA_HPP_INCLUDED
+#define STRINGARENA_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * \class StringArena
+ * \brief Keeps copies of strings back to back in large blocks, handing out
+ *        string_views of them.
+ *
+ * \details
+ * Storing a string is a copy and a pointer bump, except once per block,
+ * with none of std::string's per-string header or heap allocation.
+ * Strings stored one after another sit next to each other, and the whole
+ * lot is freed a block at a time.  Stored strings never move, so the views
+ * add() returns stay valid for as long as the arena exists.
+ */
+class StringArena {
+ public:
+    /// Characters per block (a longer string gets a block of its own).
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+    StringArena() = default;
+    ~StringArena() = default;
+
+    // Copying isn't supported.
+    StringArena(const StringArena& other) = delete;
+    StringArena& operator=(const StringArena& other) = delete;
+
+    /**
+     * \brief Stores a copy of chars.
+     * \returns A view of the copy.
+     */
+    std::string_view add(std::string_view chars);
+
+    /**
+     * \brief Total length of the strings stored so far.
+     */
+    size_t bytesUsed() const;
+
+ private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t blockUsed_ = BLOCK_BYTES;  ///< Characters used in the last block
+    size_t bytesUsed_ = 0;
+};
+
+#endif  // STRINGARENA_HPP_INCLUDED
@@ -0,0 +1,47 @@
+/**
+ * \file stringhash.hpp
+ *
+ * \brief A seeded 64-bit string hash, for the sets that need one that's the
+ *        same from run to run.
+ */
+
+#ifndef STRINGHASH_HPP_INCLUDED
+#define STRINGHASH_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * \brief The 64-bit finalizer from MurmurHash3.
+ */
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * \brief A seeded 64-bit hash of a string, eight bytes at a time.
+ */
+inline uint64_t hashString(std::string_view word, uint64_t seed) {
+    uint64_t h = mixHash(seed ^ (word.size() * 0x9e3779b97f4a7c15ULL));
+    size_t i = 0;
+    for (; i + 8 <= word.size(); i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, word.data() + i, 8);
+        h = mixHash(h ^ chunk);
+    }
+    if (i < word.size()) {
+        uint64_t chunk = 0;
+        std::memcpy(&chunk, word.data() + i, word.size() - i);
+        h = mixHash(h ^ chunk);
+    }
+    return h;
+}
+
+#endif  // STRINGHASH_HPP_INCLUDED
@@ -0,0 +1,156 @@
+/**
+ * \file stringsort.cpp
+ *
+ * \brief Implementation of multikeySort.
+ */
+
+#include "stringsort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+/**
+ * \struct Key
+ * \brief What the sort actually moves around: where a string's characters
+ *        are, and where the string itself was.  It's half the size of a
+ *        std::string and reaches the characters with one less indirection.
+ */
+struct Key {
+    const char* chars;
+    uint32_t length;
+    uint32_t index;
+};
+
+/// Below this many keys, insertion sort is faster than partitioning.
+constexpr ptrdiff_t INSERTION_SORT_CUTOFF = 16;
+
+/**
+ * \brief The character of a key at position depth, shifted up by one so
+ *        that running off the end (0) sorts before every real character.
+ */
+int charAt(const Key& key, size_t depth) {
+    return depth < key.length ? static_cast<unsigned char>(key.chars[depth]) + 1
+                              : 0;
+}
+
+/**
+ * \brief Whether lhs sorts before rhs, given that they agree on their
+ *        first depth characters.
+ */
+bool lessFrom(const Key& lhs, const Key& rhs, size_t depth) {
+    for (;; ++depth) {
+        int l = charAt(lhs, depth);
+        int r = charAt(rhs, depth);
+        if (l != r || l == 0) {
+            return l < r;
+        }
+    }
+}
+
+/**
+ * \brief Insertion sort for keys already known to agree on their first
+ *        depth characters.
+ */
+void insertionSort(Key* first, Key* last, size_t depth) {
+    for (Key* i = first + 1; i < last; ++i) {
+        Key key = *i;
+        Key* j = i;
+        while (j > first && lessFrom(key, *(j - 1), depth)) {
+            *j = *(j - 1);
+            --j;
+        }
+        *j = key;
+    }
+}
+
+/**
+ * \brief Multikey quicksort of keys that agree on their first depth
+ *        characters.
+ */
+void sortFrom(Key* first, Key* last, size_t depth) {
+    while (last - first > INSERTION_SORT_CUTOFF) {
+        // Median-of-three pivot character.
+        int a = charAt(*first, depth);
+        int b = charAt(*(first + (last - first) / 2), depth);
+        int c = charAt(*(last - 1), depth);
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // Dijkstra's three-way partition: [first, less) < pivot,
+        // [less, i) == pivot, [greater, last) > pivot.
+        Key* less = first;
+        Key* i = first;
+        Key* greater = last;
+        while (i < greater) {
+            int ch = charAt(*i, depth);
+            if (ch < pivot) {
+                std::swap(*less++, *i++);
+            } else if (ch > pivot) {
+                std::swap(*i, *--greater);
+            } else {
+                ++i;
+            }
+        }
+
+        if (pivot != 0) {
+            // Keys that ended here are all equal; the rest go deeper.
+            sortFrom(less, greater, depth + 1);
+        }
+        // Recurse on the smaller outer part and loop on the larger, so the
+        // stack stays shallow however lopsided the partitions are.
+        if (less - first < last - greater) {
+            sortFrom(first, less, depth);
+            first = greater;
+        } else {
+            sortFrom(greater, last, depth);
+            last = less;
+        }
+    }
+    insertionSort(first, last, depth);
+}
+
+}  // namespace
+
+void multikeySort(std::vector<std::string>::iterator first,
+                  std::vector<std::string>::iterator last) {
+    const size_t count = last - first;
+    if (count < 2) {
+        return;
+    }
+    std::vector<Key> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = {first[i].data(), static_cast<uint32_t>(first[i].size()),
+                   static_cast<uint32_t>(i)};
+    }
+    sortFrom(keys.data(), keys.data() + count, 0);
+
+    // Move the strings into sorted order.
+    std::vector<std::string> sorted;
+    sorted.reserve(count);
+    for (const Key& key : keys) {
+        sorted.push_back(std::move(first[key.index]));
+    }
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+void multikeySort(std::vector<std::string_view>::iterator first,
+                  std::vector<std::string_view>::iterator last) {
+    const size_t count = last - first;
+    if (count < 2) {
+        return;
+    }
+    std::vector<Key> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = {first[i].data(), static_cast<uint32_t>(first[i].size()),
+                   static_cast<uint32_t>(i)};
+    }
+    sortFrom(keys.data(), keys.data() + count, 0);
+
+    // Views are cheap to remake, so there's nothing to move.
+    for (size_t i = 0; i < count; ++i) {
+        first[i] = std::string_view(keys[i].chars, keys[i].length);
+    }
+}
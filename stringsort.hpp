@@ -0,0 +1,38 @@
+/**
+ * \file stringsort.hpp
+ *
+ * \brief A sorting algorithm specialized for strings.
+ */
+
+#ifndef STRINGSORT_HPP_INCLUDED
+#define STRINGSORT_HPP_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Sorts strings with Bentley and Sedgewick's multikey quicksort.
+ * \param first Iterator to the first string to sort.
+ * \param last  Iterator past the last string to sort.
+ *
+ * \details
+ * Rather than comparing whole strings, the sort partitions the strings
+ * three ways on a single character position: those whose character there
+ * is smaller than the pivot's, equal, or larger.  Only the "equal" group
+ * moves on to the next character.  So the characters of a prefix that
+ * many strings share (such as "inter" or "un") are examined about once per
+ * string, instead of once per comparison as in std::sort.
+ */
+void multikeySort(std::vector<std::string>::iterator first,
+                  std::vector<std::string>::iterator last);
+
+/**
+ * \brief Sorts string_views with the same multikey quicksort.
+ * \param first Iterator to the first view to sort.
+ * \param last  Iterator past the last view to sort.
+ */
+void multikeySort(std::vector<std::string_view>::iterator first,
+                  std::vector<std::string_view>::iterator last);
+
+#endif  // STRINGSORT_HPP_INCLUDED
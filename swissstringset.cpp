@@ -0,0 +1,220 @@
+/**
+ * \file swissstringset.cpp
+ *
+ * \brief Implementation of SwissStringSet.
+ */
+
+#include "swissstringset.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/// Control byte for a slot that has never held a key.  Full slots hold
+/// seven hash bits, so they are never negative.
+constexpr int8_t EMPTY = -128;
+
+/**
+ * \brief Bitmask of which of the sixteen control bytes starting at group
+ *        equal value.
+ */
+uint32_t matchByte(const int8_t* group, int8_t value) {
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        mask |= uint32_t(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/// The seven hash bits kept in the control byte.
+int8_t hashTag(size_t hash) {
+    return static_cast<int8_t>(hash & 0x7f);
+}
+
+/// The hash bits that choose the first group to probe.
+size_t hashGroup(size_t hash, size_t numGroups) {
+    return (hash >> 7) & (numGroups - 1);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------
+// ConstIterator
+// ---------------------------------------------------------------------
+
+SwissStringSet::ConstIterator::ConstIterator(const std::string* const* current)
+    : current_{current} {
+    // Nothing else to do.
+}
+
+SwissStringSet::ConstIterator::reference
+SwissStringSet::ConstIterator::operator*() const {
+    return **current_;
+}
+
+SwissStringSet::ConstIterator::pointer
+SwissStringSet::ConstIterator::operator->() const {
+    return *current_;
+}
+
+SwissStringSet::ConstIterator& SwissStringSet::ConstIterator::operator++() {
+    ++current_;
+    return *this;
+}
+
+SwissStringSet::ConstIterator SwissStringSet::ConstIterator::operator++(int) {
+    ConstIterator old = *this;
+    ++current_;
+    return old;
+}
+
+bool SwissStringSet::ConstIterator::operator==(
+    const ConstIterator& other) const {
+    return current_ == other.current_;
+}
+
+bool SwissStringSet::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+    return current_ != other.current_;
+}
+
+// ---------------------------------------------------------------------
+// SwissStringSet
+// ---------------------------------------------------------------------
+
+SwissStringSet::SwissStringSet()
+    : numGroups_{1},
+      control_{new int8_t[GROUP_SIZE]},
+      slots_{new std::string[GROUP_SIZE]} {
+    std::fill(control_.get(), control_.get() + GROUP_SIZE, EMPTY);
+}
+
+size_t SwissStringSet::size() const {
+    return size_;
+}
+
+size_t SwissStringSet::findSlot(const std::string& word, size_t hash,
+                                size_t& groupsProbed) const {
+    const int8_t tag = hashTag(hash);
+    size_t group = hashGroup(hash, numGroups_);
+    // Triangular probing visits every group when numGroups_ is a power
+    // of two.
+    for (size_t step = 1;; ++step) {
+        const int8_t* control = control_.get() + group * GROUP_SIZE;
+        const std::string* slots = slots_.get() + group * GROUP_SIZE;
+        for (uint32_t match = matchByte(control, tag); match != 0;
+             match &= match - 1) {
+            size_t i = __builtin_ctz(match);
+            if (slots[i] == word) {
+                groupsProbed = step;
+                return group * GROUP_SIZE + i;
+            }
+        }
+        uint32_t empties = matchByte(control, EMPTY);
+        if (empties != 0) {
+            groupsProbed = step;
+            return group * GROUP_SIZE + __builtin_ctz(empties);
+        }
+        group = (group + step) & (numGroups_ - 1);
+    }
+}
+
+bool SwissStringSet::exists(const std::string& word) const {
+    size_t groupsProbed;
+    size_t slot = findSlot(word, std::hash<std::string>{}(word), groupsProbed);
+    return control_[slot] != EMPTY;
+}
+
+void SwissStringSet::insert(const std::string& word) {
+    // Keep the table at most 7/8 full, counting the word we may add.
+    if ((size_ + 1) * 8 > numGroups_ * GROUP_SIZE * 7) {
+        rehash(numGroups_ * 2);
+    }
+    size_t hash = std::hash<std::string>{}(word);
+    size_t groupsProbed;
+    size_t slot = findSlot(word, hash, groupsProbed);
+    if (control_[slot] == EMPTY) {
+        control_[slot] = hashTag(hash);
+        slots_[slot] = word;
+        ++size_;
+        sortedIsCurrent_ = false;
+    }
+}
+
+void SwissStringSet::rehash(size_t numGroups) {
+    std::unique_ptr<int8_t[]> oldControl = std::move(control_);
+    std::unique_ptr<std::string[]> oldSlots = std::move(slots_);
+    size_t oldCapacity = numGroups_ * GROUP_SIZE;
+
+    numGroups_ = numGroups;
+    control_.reset(new int8_t[numGroups_ * GROUP_SIZE]);
+    slots_.reset(new std::string[numGroups_ * GROUP_SIZE]);
+    std::fill(control_.get(), control_.get() + numGroups_ * GROUP_SIZE, EMPTY);
+
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldControl[i] != EMPTY) {
+            size_t hash = std::hash<std::string>{}(oldSlots[i]);
+            size_t groupsProbed;
+            size_t slot = findSlot(oldSlots[i], hash, groupsProbed);
+            control_[slot] = oldControl[i];
+            slots_[slot] = std::move(oldSlots[i]);
+        }
+    }
+    sortedIsCurrent_ = false;
+}
+
+void SwissStringSet::sortKeys() const {
+    if (sortedIsCurrent_) {
+        return;
+    }
+    sorted_.clear();
+    sorted_.reserve(size_);
+    for (size_t i = 0; i < numGroups_ * GROUP_SIZE; ++i) {
+        if (control_[i] != EMPTY) {
+            sorted_.push_back(&slots_[i]);
+        }
+    }
+    std::sort(sorted_.begin(), sorted_.end(),
+              [](const std::string* lhs, const std::string* rhs) {
+                  return *lhs < *rhs;
+              });
+    sortedIsCurrent_ = true;
+}
+
+SwissStringSet::ConstIterator SwissStringSet::begin() const {
+    sortKeys();
+    return ConstIterator(sorted_.data());
+}
+
+SwissStringSet::ConstIterator SwissStringSet::end() const {
+    sortKeys();
+    return ConstIterator(sorted_.data() + sorted_.size());
+}
+
+void SwissStringSet::showStatistics(std::ostream& out) const {
+    size_t capacity = numGroups_ * GROUP_SIZE;
+    size_t totalProbed = 0;
+    for (size_t i = 0; i < capacity; ++i) {
+        if (control_[i] != EMPTY) {
+            size_t groupsProbed;
+            findSlot(slots_[i], std::hash<std::string>{}(slots_[i]),
+                     groupsProbed);
+            totalProbed += groupsProbed;
+        }
+    }
+    out << size_ << " keys in Swiss table, " << capacity << " slots ("
+        << (100.0 * size_ / capacity) << "% full), "
+        << (size_ == 0 ? 0.0 : double(totalProbed) / size_)
+        << " groups probed per hit\n";
+}
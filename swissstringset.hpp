@@ -0,0 +1,139 @@
+/**
+ * \file swissstringset.hpp
+ *
+ * \brief A string set stored in an open-addressing, Swiss-table-style hash
+ *        table.
+ */
+
+#ifndef SWISSSTRINGSET_HPP_INCLUDED
+#define SWISSSTRINGSET_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \class SwissStringSet
+ * \brief A hash set of strings with the same interface as TreeStringSet.
+ *
+ * \details
+ * Slots are grouped sixteen at a time.  Alongside the slots is an array of
+ * one-byte control codes, one per slot: either EMPTY, or the low seven bits
+ * of the hash of the key in that slot.  A lookup compares those seven bits
+ * against a whole group of control bytes at once (with one SSE2 compare
+ * where available), and only looks at the keys whose bytes match, so it
+ * almost never compares more than one string.
+ *
+ * Keys are never removed, so there are no tombstones: a group with an
+ * EMPTY byte ends every probe sequence that reaches it.
+ *
+ * The table keeps no order.  Iteration visits the keys in ascending order
+ * by sorting pointers to them the first time begin() is called after an
+ * insert, so begin() is not safe to call from several threads at once.
+ * exists() only reads the table, so it is, provided no thread is inserting.
+ */
+class SwissStringSet {
+ public:
+    /**
+     * \class ConstIterator
+     * \brief A forward iterator over the keys, in ascending order.
+     */
+    class ConstIterator {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        ConstIterator() = default;
+        ConstIterator(const ConstIterator& other) = default;
+        ConstIterator& operator=(const ConstIterator& other) = default;
+        ~ConstIterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator& other) const;
+        bool operator!=(const ConstIterator& other) const;
+
+     private:
+        friend class SwissStringSet;
+        explicit ConstIterator(const std::string* const* current);
+
+        const std::string* const* current_ = nullptr;
+    };
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    SwissStringSet();
+    ~SwissStringSet() = default;
+
+    // Copying isn't supported.
+    SwissStringSet(const SwissStringSet& other) = delete;
+    SwissStringSet& operator=(const SwissStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there).
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the table's occupancy.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    static constexpr size_t GROUP_SIZE = 16;
+
+    /**
+     * \brief Finds the slot holding word, or the EMPTY slot where it would
+     *        go if it isn't there.
+     * \param[out] groupsProbed How many groups the search looked at.
+     */
+    size_t findSlot(const std::string& word, size_t hash,
+                    size_t& groupsProbed) const;
+
+    /**
+     * \brief Moves every key into a table with the given number of groups.
+     */
+    void rehash(size_t numGroups);
+
+    /**
+     * \brief Rebuilds sorted_ if an insert has made it stale.
+     */
+    void sortKeys() const;
+
+    size_t numGroups_;
+    std::unique_ptr<int8_t[]> control_;       ///< One byte per slot
+    std::unique_ptr<std::string[]> slots_;
+    size_t size_ = 0;
+
+    mutable std::vector<const std::string*> sorted_;
+    mutable bool sortedIsCurrent_ = true;
+};
+
+#endif  // SWISSSTRINGSET_HPP_INCLUDED
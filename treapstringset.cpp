@@ -0,0 +1,104 @@
+/**
+ * \file treapstringset.cpp
+ *
+ * \brief Implementation of TreapStringSet.
+ */
+
+#include "treapstringset.hpp"
+#include "stringhash.hpp"
+
+#include <utility>
+
+// ---------------------------------------------------------------------
+// TreapStringSet
+// ---------------------------------------------------------------------
+
+TreapStringSet::TreapStringSet(uint64_t seed) : seed_{seed} {
+    // nodes_[NONE] holds no key.
+}
+
+size_t TreapStringSet::size() const {
+    return nodes_.size() - 1;
+}
+
+uint64_t TreapStringSet::priority(NodeIndex i) const {
+    return hashString(nodes_.key(i), seed_);
+}
+
+bool TreapStringSet::exists(const std::string& word) const {
+    size_t compares = 0;
+    return nodes_.find(root_, word, compares) != NONE;
+}
+
+void TreapStringSet::insert(const std::string& word) {
+    // Add the word as a leaf, remembering the path to it.
+    NodeIndex added = nodes_.insertLeaf(root_, word, path_);
+    if (added == NONE) {
+        return;
+    }
+    sorted_.invalidate();
+
+    // Rotate it up past every ancestor with a lower priority.
+    uint64_t addedPriority = priority(added);
+    while (!path_.empty() && priority(path_.back()) < addedPriority) {
+        NodeIndex parent = path_.back();
+        path_.pop_back();
+        if (nodes_[parent].left == added) {
+            nodes_[parent].left = nodes_[added].right;
+            nodes_[added].right = parent;
+        } else {
+            nodes_[parent].right = nodes_[added].left;
+            nodes_[added].left = parent;
+        }
+        ++rotations_;
+
+        if (path_.empty()) {
+            root_ = added;
+        } else if (nodes_[path_.back()].left == parent) {
+            nodes_[path_.back()].left = added;
+        } else {
+            nodes_[path_.back()].right = added;
+        }
+    }
+}
+
+void TreapStringSet::buildFromSorted(std::vector<std::string>&& words) {
+    nodes_.assign(std::move(words));
+
+    // path_ holds the right spine of the tree built so far, root first.
+    path_.clear();
+    for (NodeIndex added = 1; added < nodes_.size(); ++added) {
+        uint64_t addedPriority = priority(added);
+        NodeIndex below = NONE;
+        while (!path_.empty() && priority(path_.back()) < addedPriority) {
+            below = path_.back();
+            path_.pop_back();
+        }
+        nodes_[added].left = below;
+        if (!path_.empty()) {
+            nodes_[path_.back()].right = added;
+        }
+        path_.push_back(added);
+    }
+    root_ = path_.empty() ? NONE : path_.front();
+    sorted_.invalidate();
+}
+
+size_t TreapStringSet::height() const {
+    return nodes_.height(root_);
+}
+
+TreapStringSet::ConstIterator TreapStringSet::begin() const {
+    return sorted_.begin(nodes_, root_);
+}
+
+TreapStringSet::ConstIterator TreapStringSet::end() const {
+    return sorted_.end(nodes_, root_);
+}
+
+void TreapStringSet::showStatistics(std::ostream& out) const {
+    out << size() << " nodes in treap (seed " << seed_ << "), height "
+        << height() << ", " << rotations_ << " rotations while inserting";
+    nodes_.showBytes(out);
+    out << "\n";
+}
@@ -0,0 +1,126 @@
+/**
+ * \file treapstringset.hpp
+ *
+ * \brief A string set stored in a treap.
+ */
+
+#ifndef TREAPSTRINGSET_HPP_INCLUDED
+#define TREAPSTRINGSET_HPP_INCLUDED
+
+#include "indexednode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \class TreapStringSet
+ * \brief A randomized binary search tree of strings, with the same
+ *        interface as TreeStringSet.
+ *
+ * \details
+ * Each key has a priority, and besides being a search tree on the keys,
+ * the tree is a max-heap on the priorities: after an insert adds a leaf,
+ * rotations lift it until its parent's priority is higher.  The shape is
+ * then exactly the one the keys would have been given by inserting them
+ * in decreasing order of priority.  With random priorities, that's the
+ * shape of a randomly shuffled insertion, whatever order the keys really
+ * arrive in, so the expected height is O(log n) without shuffling
+ * anything.
+ *
+ * The priority is a seeded hash of the key, so nodes don't store it
+ * (they hold only a key and two child links), and the same words and
+ * seed always make the same tree.
+ *
+ * Nodes are IndexedNodes; see there for their layout and for which calls
+ * may run on several threads at once.
+ */
+class TreapStringSet {
+ public:
+    using ConstIterator = KeyListIterator;
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    /// The priority seed used unless another is given.
+    static constexpr uint64_t DEFAULT_SEED = 0x5eed;
+
+    /**
+     * \brief Creates an empty set.
+     * \param seed Seeds the hash that gives each key its priority.
+     */
+    explicit TreapStringSet(uint64_t seed = DEFAULT_SEED);
+    ~TreapStringSet() = default;
+
+    // Copying isn't supported.
+    TreapStringSet(const TreapStringSet& other) = delete;
+    TreapStringSet& operator=(const TreapStringSet& other) = delete;
+
+    /**
+     * \brief Adds a string to the set (does nothing if it's already there).
+     * \param word The string to add.
+     */
+    void insert(const std::string& word);
+
+    /**
+     * \brief Replaces the set's contents with sorted, distinct words, in
+     *        O(n) time and without comparing any keys.
+     *
+     * \details
+     * The shape is still the one the priorities dictate, not a perfectly
+     * balanced one, so it's built as a Cartesian tree: each word in turn
+     * goes on the tree's right spine, taking as its left subtree the part
+     * of the spine with lower priorities.
+     *
+     * \param words The words, in ascending order with no repeats; the
+     *        vector gives them up.
+     */
+    void buildFromSorted(std::vector<std::string>&& words);
+
+    /**
+     * \brief Looks for a string in the set.
+     * \param word The string to look for.
+     * \returns True if the word is in the set.
+     */
+    bool exists(const std::string& word) const;
+
+    /**
+     * \brief Number of strings in the set.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Number of levels in the tree.
+     */
+    size_t height() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**
+     * \brief Prints a one-line summary of the tree's shape.
+     * \param out The stream to print to.
+     */
+    void showStatistics(std::ostream& out) const;
+
+ private:
+    /// Index meaning "no node"; nodes_[NONE] is never used.
+    static constexpr NodeIndex NONE = NodeStore::NONE;
+
+    /**
+     * \brief The heap priority of the key at index i.
+     */
+    uint64_t priority(NodeIndex i) const;
+
+    uint64_t seed_;
+    NodeStore nodes_;
+    NodeIndex root_ = NONE;
+    size_t rotations_ = 0;
+
+    std::vector<NodeIndex> path_;  ///< Scratch space for insert()
+
+    SortedKeyList sorted_;
+};
+
+#endif  // TREAPSTRINGSET_HPP_INCLUDED
@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# tsan-check.sh: build minispell with ThreadSanitizer and run its
+# multi-threaded phases (-j) against every dictionary backend.
+#
+# Usage: ./tsan-check.sh [-j N] [minispell options and files ...]
+#
+# The options and files are passed to every run, e.g.
+#     ./tsan-check.sh -j 8 -d words.txt -n 50000 -m 50000 check.txt
+# Exits nonzero if the build fails or any run fails or draws a report.
+
+set -u
+
+JOBS=4
+if [ "${1:-}" = "-j" ]; then
+    JOBS=$2
+    shift 2
+fi
+
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# minispell's own sources, named so that other programs in the directory
+# (test drivers and the like, with main()s of their own) stay out.
+SOURCES="minispell.cpp treestringset.cpp frozenstringset.cpp
+         swissstringset.cpp perfecthashstringset.cpp bloomfilter.cpp
+         stringsort.cpp stringarena.cpp indexednode.cpp splaystringset.cpp
+         scapegoatstringset.cpp treapstringset.cpp redblackstringset.cpp"
+
+echo "Building with -fsanitize=thread..."
+# Word splitting of $CXXFLAGS and $SOURCES is intended.
+# shellcheck disable=SC2086
+(cd "$DIR" && "$CXX" -std=c++17 -g -O1 -fsanitize=thread -pthread \
+    ${CXXFLAGS:-} $SOURCES -o "$WORK/minispell") || exit 1
+
+# -S may only be searched from several threads once it's frozen, and
+# -b sorts on several threads, so each backend runs both ways.
+BACKENDS="|-B|-B -A|-H|-P|-S -F|-G|-T|-R|-F|-F -g 8"
+
+export TSAN_OPTIONS="halt_on_error=1 exitcode=66 ${TSAN_OPTIONS:-}"
+failures=0
+
+run() {
+    printf '  minispell %s ... ' "$*"
+    if "$WORK/minispell" "$@" > "$WORK/out" 2>&1; then
+        echo ok
+    else
+        echo FAILED
+        cat "$WORK/out"
+        failures=$((failures + 1))
+    fi
+}
+
+IFS='|'
+for backend in $BACKENDS; do
+    unset IFS
+    # Word splitting of $backend is intended.
+    # shellcheck disable=SC2086
+    run -j "$JOBS" $backend "$@"
+    # shellcheck disable=SC2086
+    run -j "$JOBS" -b $backend "$@"
+    IFS='|'
+done
+unset IFS
+
+# Lookups in a mapped snapshot.  -l won't take the options that say how
+# to build a dictionary, so they're dropped from its run.
+run_snapshot() {
+    left=$#
+    while [ "$left" -gt 0 ]; do
+        case $1 in
+            -d|--dict-file|-n|--num-dict-words|-z|--sorted-words|-t|--train\
+            |-a|--alpha|-e|--seed)
+                shift
+                left=$((left - 1))
+                if [ "$left" -gt 0 ]; then
+                    shift
+                    left=$((left - 1))
+                fi
+                continue
+                ;;
+            -f|--file-order|-s|--shuffled-order|-b|--balanced-order\
+            |-r|--rebalance|-B|--btree|-A|--arena|-H|--hash\
+            |-P|--perfect-hash|-S|--splay|-G|--scapegoat|-T|--treap\
+            |-R|--red-black)
+                ;;
+            *)
+                set -- "$@" "$1"
+                ;;
+        esac
+        shift
+        left=$((left - 1))
+    done
+    run -j "$JOBS" -l "$WORK/snapshot" "$@"
+}
+run -j "$JOBS" -F -w "$WORK/snapshot" "$@"
+run_snapshot "$@"
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures run(s) failed"
+    exit 1
+fi
+echo "All runs clean"